@@ -0,0 +1,67 @@
+#pragma once
+// Arduino core for the native host build: time, random numbers, math
+// helpers, String and Serial. Enough to run effects off-device, nothing
+// that talks to hardware.
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+
+#include <avr/pgmspace.h>
+#include "WString.h"
+#include "Print.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+using std::abs;
+using std::max;
+using std::min;
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define sq(x) ((x) * (x))
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+
+// Milliseconds and microseconds since start of the program
+uint32_t millis();
+uint32_t micros();
+// Returns right away, nothing on the host waits for hardware
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// Same LCG on every host, so seeded runs repeat across compilers and libcs
+void randomSeed(uint32_t seed);
+long random(long howbig);
+long random(long howsmall, long howbig);
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Serial writes to stdout
+class HardwareSerial : public Print
+{
+public:
+    void begin(unsigned long baud) {}
+    void flush() {}
+    size_t write(uint8_t value) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,260 @@
+#pragma once
+// FastLED_NeoMatrix and the parts of Framebuffer_GFX the lamp uses, for the
+// native host build. Pixels go straight into the led array, single panel
+// wiring comes from the NEO_MATRIX_* flags or the remap function.
+#include <Arduino.h>
+#include <FastLED.h>
+
+#define NEO_MATRIX_TOP 0x00
+#define NEO_MATRIX_BOTTOM 0x01
+#define NEO_MATRIX_LEFT 0x00
+#define NEO_MATRIX_RIGHT 0x02
+#define NEO_MATRIX_CORNER 0x03
+#define NEO_MATRIX_ROWS 0x00
+#define NEO_MATRIX_COLUMNS 0x04
+#define NEO_MATRIX_AXIS 0x04
+#define NEO_MATRIX_PROGRESSIVE 0x00
+#define NEO_MATRIX_ZIGZAG 0x08
+#define NEO_MATRIX_SEQUENCE 0x08
+
+#define NEO_TILE_TOP 0x00
+#define NEO_TILE_BOTTOM 0x10
+#define NEO_TILE_LEFT 0x00
+#define NEO_TILE_RIGHT 0x20
+#define NEO_TILE_CORNER 0x30
+#define NEO_TILE_ROWS 0x00
+#define NEO_TILE_COLUMNS 0x40
+#define NEO_TILE_AXIS 0x40
+#define NEO_TILE_PROGRESSIVE 0x00
+#define NEO_TILE_ZIGZAG 0x80
+#define NEO_TILE_SEQUENCE 0x80
+
+class Framebuffer_GFX : public Print
+{
+public:
+    Framebuffer_GFX(CRGB *leds, uint16_t w, uint16_t h, uint8_t tilesX, uint8_t tilesY, uint8_t matrixType)
+        : WIDTH(w), HEIGHT(h), _width(w), _height(h), type(matrixType), _fb(leds)
+    {
+    }
+    virtual ~Framebuffer_GFX() {}
+
+    void begin() {}
+    void newLedsPtr(CRGB *leds) { _fb = leds; }
+    void setRemapFunction(uint16_t (*fn)(uint16_t, uint16_t)) { remapFn = fn; }
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+    virtual void setRotation(uint8_t r)
+    {
+        rotation = r & 3;
+        if (rotation & 1) {
+            _width = HEIGHT;
+            _height = WIDTH;
+        }
+        else {
+            _width = WIDTH;
+            _height = HEIGHT;
+        }
+    }
+
+    uint16_t XY(int16_t x, int16_t y)
+    {
+        int16_t t;
+        switch (rotation) {
+        case 1:
+            t = x;
+            x = WIDTH - 1 - y;
+            y = t;
+            break;
+        case 2:
+            x = WIDTH - 1 - x;
+            y = HEIGHT - 1 - y;
+            break;
+        case 3:
+            t = x;
+            x = y;
+            y = HEIGHT - 1 - t;
+            break;
+        }
+        if (remapFn) {
+            return remapFn(x, y);
+        }
+
+        if (type & NEO_MATRIX_RIGHT) {
+            x = WIDTH - 1 - x;
+        }
+        if (type & NEO_MATRIX_BOTTOM) {
+            y = HEIGHT - 1 - y;
+        }
+        const bool zigzag = (type & NEO_MATRIX_SEQUENCE) == NEO_MATRIX_ZIGZAG;
+        if ((type & NEO_MATRIX_AXIS) == NEO_MATRIX_ROWS) {
+            if (zigzag && (y & 1)) {
+                x = WIDTH - 1 - x;
+            }
+            return y * WIDTH + x;
+        }
+        if (zigzag && (x & 1)) {
+            y = HEIGHT - 1 - y;
+        }
+        return x * HEIGHT + y;
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color)
+    {
+        if (x < 0 || y < 0 || x >= _width || y >= _height) {
+            return;
+        }
+        _fb[XY(x, y)] = passThruFlag ? CRGB(passThruColor) : CRGB(expandColor(color));
+    }
+
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+    {
+        const bool steep = abs(y1 - y0) > abs(x1 - x0);
+        if (steep) {
+            std::swap(x0, y0);
+            std::swap(x1, y1);
+        }
+        if (x0 > x1) {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+        }
+        const int16_t dx = x1 - x0;
+        const int16_t dy = abs(y1 - y0);
+        int16_t err = dx / 2;
+        const int16_t ystep = y0 < y1 ? 1 : -1;
+        for (; x0 <= x1; x0++) {
+            if (steep) {
+                drawPixel(y0, x0, color);
+            }
+            else {
+                drawPixel(x0, y0, color);
+            }
+            err -= dy;
+            if (err < 0) {
+                y0 += ystep;
+                err += dx;
+            }
+        }
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+        for (int16_t i = x; i < x + w; ++i) {
+            for (int16_t j = y; j < y + h; ++j) {
+                drawPixel(i, j, color);
+            }
+        }
+    }
+
+    void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+    void setPassThruColor(uint32_t c)
+    {
+        passThruColor = c;
+        passThruFlag = true;
+    }
+    void setPassThruColor() { passThruFlag = false; }
+
+    void setBrightness(uint8_t b) { FastLED.setBrightness(b); }
+
+    // Text is measured but not drawn, no effect on the host prints
+    void setCursor(int16_t x, int16_t y)
+    {
+        cursor_x = x;
+        cursor_y = y;
+    }
+    void setTextColor(uint16_t c) {}
+    void setTextColor(uint16_t c, uint16_t bg) {}
+    void setTextWrap(bool w) {}
+    void setTextSize(uint8_t s) {}
+    size_t write(uint8_t c) override
+    {
+        cursor_x += 6;
+        return 1;
+    }
+    using Print::write;
+
+    static uint16_t Color(uint8_t r, uint8_t g, uint8_t b)
+    {
+        return ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | (b >> 3);
+    }
+
+    static uint16_t Color24to16(uint32_t color)
+    {
+        return ((uint16_t)(((color & 0xFF0000) >> 16) & 0xF8) << 8) |
+               ((uint16_t)(((color & 0x00FF00) >> 8) & 0xFC) << 3) |
+               (((color & 0x0000FF) >> 0) >> 3);
+    }
+
+    static uint32_t expandColor(uint16_t color)
+    {
+        return ((uint32_t)pgm_read_byte(&gamma5[color >> 11]) << 16) |
+               ((uint32_t)pgm_read_byte(&gamma6[(color >> 5) & 0x3F]) << 8) |
+               pgm_read_byte(&gamma5[color & 0x1F]);
+    }
+
+protected:
+    // Bounds of one glyph of the built in 6x8 font
+    void charBounds(char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy)
+    {
+        if (c == '\n') {
+            *x = 0;
+            *y += 8;
+        }
+        else if (c != '\r') {
+            const int16_t x2 = *x + 6 - 1;
+            const int16_t y2 = *y + 8 - 1;
+            if (x2 > *maxx) {
+                *maxx = x2;
+            }
+            if (y2 > *maxy) {
+                *maxy = y2;
+            }
+            if (*x < *minx) {
+                *minx = *x;
+            }
+            if (*y < *miny) {
+                *miny = *y;
+            }
+            *x += 6;
+        }
+    }
+
+    const int16_t WIDTH;
+    const int16_t HEIGHT;
+    int16_t _width;
+    int16_t _height;
+    int16_t cursor_x = 0;
+    int16_t cursor_y = 0;
+    uint8_t rotation = 0;
+    uint8_t type;
+    CRGB *_fb;
+
+private:
+    static constexpr uint8_t gamma5[32] = {
+        0x00, 0x01, 0x02, 0x03, 0x05, 0x07, 0x09, 0x0b, 0x0e, 0x11, 0x14, 0x18, 0x1d, 0x22, 0x28, 0x2e,
+        0x36, 0x3d, 0x46, 0x4f, 0x59, 0x64, 0x6f, 0x7c, 0x89, 0x97, 0xa6, 0xb6, 0xc7, 0xd9, 0xeb, 0xff
+    };
+    static constexpr uint8_t gamma6[64] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0d, 0x0e, 0x0f, 0x10,
+        0x12, 0x13, 0x14, 0x16, 0x17, 0x19, 0x1b, 0x1c, 0x1e, 0x20, 0x22, 0x24, 0x26, 0x28, 0x2a, 0x2c,
+        0x2e, 0x31, 0x33, 0x35, 0x38, 0x3a, 0x3d, 0x40, 0x43, 0x46, 0x49, 0x4c, 0x4f, 0x52, 0x56, 0x59,
+        0x5d, 0x60, 0x64, 0x68, 0x6c, 0x70, 0x74, 0x79, 0x7d, 0x82, 0x87, 0x8b, 0x90, 0x96, 0x9b, 0xff
+    };
+
+    uint16_t (*remapFn)(uint16_t, uint16_t) = nullptr;
+    uint32_t passThruColor = 0;
+    bool passThruFlag = false;
+};
+
+class FastLED_NeoMatrix : public Framebuffer_GFX
+{
+public:
+    FastLED_NeoMatrix(CRGB *leds, uint16_t w, uint16_t h, uint8_t tilesX, uint8_t tilesY, uint8_t matrixType)
+        : Framebuffer_GFX(leds, w, h, tilesX, tilesY, matrixType)
+    {
+    }
+
+    void show() { FastLED.show(); }
+};
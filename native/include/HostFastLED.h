@@ -0,0 +1,36 @@
+#pragma once
+// Platform layer of FastLED 3.4 for the native host build, force included
+// by env:native. led_sysdefs.h and platforms.h only know microcontrollers,
+// their include guards are taken here and what the rest of FastLED needs
+// from them follows. Everything else, including lib8tion, noise,
+// colorutils, hsv2rgb and colorpalettes, is FastLED's own code from the
+// package in lib_deps. Controllers are stubbed in native/src/FastLED.cpp.
+#include <Arduino.h>
+
+#define __INC_LED_SYSDEFS_H
+#define __INC_PLATFORMS_H
+
+#define FASTLED_NAMESPACE_BEGIN
+#define FASTLED_NAMESPACE_END
+#define FASTLED_USING_NAMESPACE
+
+// one address space, palettes and noise tables are plain memory
+#define FASTLED_USE_PROGMEM 0
+#define FASTLED_ALLOW_INTERRUPTS 1
+#define INTERRUPT_THRESHOLD 0
+
+// same clock as the ESP32, only timing macros of clockless chipsets use it
+#define F_CPU 240000000L
+#define CLKS_PER_US (F_CPU / 1000000)
+
+typedef volatile uint32_t RoReg;
+typedef volatile uint32_t RwReg;
+
+// Pins for FastPin and Pin, nothing on the host is wired
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define digitalPinToBitMask(pin) (0)
+#define digitalPinToPort(pin) (0)
+#define portOutputRegister(port) (nullptr)
+#define portInputRegister(port) (nullptr)
+inline void pinMode(uint8_t pin, uint8_t mode) {}
@@ -0,0 +1,11 @@
+#pragma once
+#include <FastLED.h>
+
+#include <functional>
+
+// Starts a fresh instance of the effect made by factory on a cleared
+// matrix, with random numbers seeded and the effect clock held, and ticks
+// it frames times with its own frame interval. onFrame sees the leds after
+// every tick. Returns the time spent in tick() in nanoseconds.
+uint64_t renderEffect(uint8_t factory, uint16_t frames, uint32_t seed,
+                      const std::function<void(uint16_t frame, const CRGB* leds)>& onFrame);
@@ -0,0 +1,79 @@
+#pragma once
+#include <stdarg.h>
+#include <stdio.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t written = 0;
+        while (size-- > 0) {
+            written += write(*buffer++);
+        }
+        return written;
+    }
+    size_t write(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        va_list args;
+        va_start(args, format);
+        const size_t written = writeFormatted(format, args);
+        va_end(args);
+        return written;
+    }
+    size_t printf_P(PGM_P format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        va_list args;
+        va_start(args, format);
+        const size_t written = writeFormatted(format, args);
+        va_end(args);
+        return written;
+    }
+
+    size_t print(const char *text) { return write(text); }
+    size_t print(const __FlashStringHelper *text) { return write(reinterpret_cast<const char *>(text)); }
+    size_t print(const String &text) { return write(reinterpret_cast<const uint8_t *>(text.c_str()), text.length()); }
+    size_t print(char value) { return write(static_cast<uint8_t>(value)); }
+    size_t print(unsigned char value, int base = DEC) { return print(String(value, base)); }
+    size_t print(int value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned int value, int base = DEC) { return print(String(value, base)); }
+    size_t print(long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(double value, int digits = 2) { return print(String(value, digits)); }
+
+    size_t println() { return write('\n'); }
+    template <typename T>
+    size_t println(const T &value)
+    {
+        return print(value) + println();
+    }
+    template <typename T>
+    size_t println(const T &value, int format)
+    {
+        return print(value, format) + println();
+    }
+
+private:
+    size_t writeFormatted(const char *format, va_list args)
+    {
+        char *text = nullptr;
+        const int length = vasprintf(&text, format, args);
+        if (length < 0) {
+            return 0;
+        }
+        const size_t written = write(reinterpret_cast<const uint8_t *>(text), length);
+        free(text);
+        return written;
+    }
+};
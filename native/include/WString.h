@@ -0,0 +1,225 @@
+#pragma once
+// Arduino String for the native host build, backed by std::string. Covers
+// what the effects, the matrix and ArduinoJson use.
+#include <avr/pgmspace.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <string>
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+
+class String
+{
+public:
+    String() {}
+    String(const char *value) : data(value ? value : "") {}
+    String(const char *value, unsigned int length) : data(value, length) {}
+    String(const __FlashStringHelper *value) : String(reinterpret_cast<const char *>(value)) {}
+    String(const std::string &value) : data(value) {}
+    explicit String(char value) : data(1, value) {}
+    explicit String(unsigned char value, unsigned char base = 10) : String(static_cast<unsigned long>(value), base) {}
+    explicit String(int value, unsigned char base = 10) : String(static_cast<long>(value), base) {}
+    explicit String(unsigned int value, unsigned char base = 10) : String(static_cast<unsigned long>(value), base) {}
+    explicit String(long value, unsigned char base = 10)
+    {
+        if (value < 0 && base == 10) {
+            data = "-" + String(static_cast<unsigned long>(-value)).data;
+        }
+        else {
+            data = String(static_cast<unsigned long>(value), base).data;
+        }
+    }
+    explicit String(unsigned long value, unsigned char base = 10)
+    {
+        do {
+            const unsigned digit = value % base;
+            data.insert(data.begin(), static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10));
+            value /= base;
+        } while (value > 0);
+    }
+    explicit String(float value, unsigned char decimalPlaces = 2) : String(static_cast<double>(value), decimalPlaces) {}
+    explicit String(double value, unsigned char decimalPlaces = 2)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimalPlaces, value);
+        data = buffer;
+    }
+
+    bool reserve(unsigned int size)
+    {
+        data.reserve(size);
+        return true;
+    }
+    unsigned int length() const { return data.length(); }
+    bool isEmpty() const { return data.empty(); }
+    const char *c_str() const { return data.c_str(); }
+    char *begin() { return &data[0]; }
+    char *end() { return &data[0] + data.length(); }
+    const char *begin() const { return data.c_str(); }
+    const char *end() const { return data.c_str() + data.length(); }
+
+    bool concat(const String &value)
+    {
+        data += value.data;
+        return true;
+    }
+    bool concat(const char *value)
+    {
+        if (!value) {
+            return false;
+        }
+        data += value;
+        return true;
+    }
+    bool concat(const char *value, unsigned int length)
+    {
+        data.append(value, length);
+        return true;
+    }
+    bool concat(const __FlashStringHelper *value) { return concat(reinterpret_cast<const char *>(value)); }
+    bool concat(char value)
+    {
+        data += value;
+        return true;
+    }
+    bool concat(unsigned char value) { return concat(String(value)); }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    bool concat(float value) { return concat(String(value)); }
+    bool concat(double value) { return concat(String(value)); }
+
+    template <typename T>
+    String &operator+=(const T &value)
+    {
+        concat(value);
+        return *this;
+    }
+
+    bool equals(const String &other) const { return data == other.data; }
+    bool equals(const char *other) const { return data == (other ? other : ""); }
+    bool equalsIgnoreCase(const String &other) const { return strcasecmp(c_str(), other.c_str()) == 0; }
+    int compareTo(const String &other) const { return data.compare(other.data); }
+    bool operator==(const String &other) const { return equals(other); }
+    bool operator==(const char *other) const { return equals(other); }
+    bool operator==(const __FlashStringHelper *other) const { return equals(reinterpret_cast<const char *>(other)); }
+    bool operator!=(const String &other) const { return !equals(other); }
+    bool operator!=(const char *other) const { return !equals(other); }
+    bool operator!=(const __FlashStringHelper *other) const { return !(*this == other); }
+    bool operator<(const String &other) const { return data < other.data; }
+    bool operator>(const String &other) const { return data > other.data; }
+    bool startsWith(const String &prefix) const { return data.compare(0, prefix.data.length(), prefix.data) == 0; }
+    bool endsWith(const String &suffix) const
+    {
+        return data.length() >= suffix.data.length()
+            && data.compare(data.length() - suffix.data.length(), suffix.data.length(), suffix.data) == 0;
+    }
+
+    char charAt(unsigned int index) const { return index < data.length() ? data[index] : 0; }
+    void setCharAt(unsigned int index, char value)
+    {
+        if (index < data.length()) {
+            data[index] = value;
+        }
+    }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index) { return data[index]; }
+
+    int indexOf(char value, unsigned int from = 0) const { return position(data.find(value, from)); }
+    int indexOf(const String &value, unsigned int from = 0) const { return position(data.find(value.data, from)); }
+    int lastIndexOf(char value) const { return position(data.rfind(value)); }
+    int lastIndexOf(const String &value) const { return position(data.rfind(value.data)); }
+    String substring(unsigned int from) const { return from < data.length() ? String(data.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > to) {
+            const unsigned int swap = from;
+            from = to;
+            to = swap;
+        }
+        return from < data.length() ? String(data.substr(from, to - from)) : String();
+    }
+
+    void replace(char from, char to)
+    {
+        for (char &value : data) {
+            if (value == from) {
+                value = to;
+            }
+        }
+    }
+    void replace(const String &from, const String &to)
+    {
+        if (from.data.empty()) {
+            return;
+        }
+        for (size_t at = data.find(from.data); at != std::string::npos; at = data.find(from.data, at + to.data.length())) {
+            data.replace(at, from.data.length(), to.data);
+        }
+    }
+    void remove(unsigned int index) { remove(index, data.length()); }
+    void remove(unsigned int index, unsigned int count)
+    {
+        if (index < data.length()) {
+            data.erase(index, count);
+        }
+    }
+    void toLowerCase()
+    {
+        for (char &value : data) {
+            value = tolower(value);
+        }
+    }
+    void toUpperCase()
+    {
+        for (char &value : data) {
+            value = toupper(value);
+        }
+    }
+    void trim()
+    {
+        const size_t first = data.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            data.clear();
+            return;
+        }
+        data = data.substr(first, data.find_last_not_of(" \t\r\n") - first + 1);
+    }
+
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+    double toDouble() const { return atof(c_str()); }
+
+private:
+    static int position(size_t at) { return at == std::string::npos ? -1 : static_cast<int>(at); }
+
+    std::string data;
+};
+
+// Type of concatenation results in the Arduino cores, ArduinoJson looks for it
+class StringSumHelper : public String
+{
+public:
+    using String::String;
+    StringSumHelper(const String &value) : String(value) {}
+};
+
+template <typename T>
+inline StringSumHelper operator+(const String &left, const T &right)
+{
+    StringSumHelper sum(left);
+    sum.concat(right);
+    return sum;
+}
+
+inline StringSumHelper operator+(const char *left, const String &right)
+{
+    StringSumHelper sum(left);
+    sum.concat(right);
+    return sum;
+}
@@ -0,0 +1,24 @@
+#pragma once
+// Flash access for the native host build: there is only one address space,
+// so everything reads plain memory. Macros, not functions, so ArduinoJson
+// doesn't add its own fallbacks.
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t *>(addr))
+#define pgm_read_float(addr) (*reinterpret_cast<const float *>(addr))
+#define pgm_read_ptr(addr) (*reinterpret_cast<void *const *>(addr))
+
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcasecmp_P strcasecmp
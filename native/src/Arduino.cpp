@@ -0,0 +1,76 @@
+#include <Arduino.h>
+
+#include <chrono>
+#include <stdio.h>
+
+HardwareSerial Serial;
+
+namespace {
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    uint32_t randomState = 1;
+
+    uint32_t nextRandom()
+    {
+        // LCG of the C standard's sample rand(), 31 bits
+        randomState = randomState * 1103515245u + 12345u;
+        return randomState & 0x7FFFFFFF;
+    }
+
+} // namespace
+
+uint32_t millis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+uint32_t micros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(uint32_t ms)
+{
+}
+
+void delayMicroseconds(uint32_t us)
+{
+}
+
+void yield()
+{
+}
+
+void randomSeed(uint32_t seed)
+{
+    if (seed != 0) {
+        randomState = seed;
+    }
+}
+
+long random(long howbig)
+{
+    if (howbig <= 0) {
+        return 0;
+    }
+    return nextRandom() % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+    if (howsmall >= howbig) {
+        return howsmall;
+    }
+    return random(howbig - howsmall) + howsmall;
+}
+
+size_t HardwareSerial::write(uint8_t value)
+{
+    return fwrite(&value, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, stdout);
+}
@@ -0,0 +1,26 @@
+// Controller layer of FastLED for the native host build: no controllers
+// are added, so FastLED only keeps its settings and frames stay in the
+// led arrays. Constructor as in FastLED.cpp, which isn't built here.
+#include <FastLED.h>
+
+CFastLED FastLED;
+
+CFastLED::CFastLED()
+{
+    m_Scale = 255;
+    m_nFPS = 0;
+    m_pPowerFunc = nullptr;
+    m_nPowerData = 0xFFFFFFFF;
+}
+
+void CFastLED::show(uint8_t scale)
+{
+}
+
+void CFastLED::clear(bool writeData)
+{
+}
+
+void CFastLED::setDither(uint8_t ditherMode)
+{
+}
@@ -0,0 +1,32 @@
+#include "HostRender.h"
+#include "EffectClock.h"
+#include "EffectFactories.h"
+#include "MyMatrix.h"
+
+#include <chrono>
+
+uint64_t renderEffect(uint8_t factory, uint16_t frames, uint32_t seed,
+                      const std::function<void(uint16_t frame, const CRGB* leds)>& onFrame)
+{
+    CRGB* leds = myMatrix->getLeds();
+    fill_solid(leds, myMatrix->getNumLeds(), CRGB::Black);
+    randomSeed(seed);
+    random16_set_seed(seed);
+
+    Effect* effect = EffectFactories::create(factory, EffectFactories::id(factory));
+    EffectClock::hold();
+    effect->start();
+    const uint32_t dt = effect->frameInterval();
+    uint64_t elapsed = 0;
+    for (uint16_t frame = 0; frame < frames; ++frame) {
+        EffectClock::advance(dt);
+        const auto start = std::chrono::steady_clock::now();
+        effect->tick(dt);
+        elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        onFrame(frame, leds);
+    }
+    effect->stop();
+    delete effect;
+    EffectClock::release();
+    return elapsed;
+}
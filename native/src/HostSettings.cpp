@@ -0,0 +1,29 @@
+#include "Settings.h"
+
+// Settings of the native host build: defaults only, nothing is read from
+// or saved to flash. Tools change matrixSettings before MyMatrix::Initialize().
+
+namespace {
+
+    Settings* object = nullptr;
+
+} // namespace
+
+Settings* Settings::instance()
+{
+    return object;
+}
+
+void Settings::Initialize(uint32_t saveInterval)
+{
+    if (object) {
+        return;
+    }
+
+    object = new Settings(saveInterval);
+}
+
+Settings::Settings(uint32_t saveInterval)
+{
+    matrixSettings.order = F("grb");
+}
@@ -0,0 +1,41 @@
+#include "Spectrometer.h"
+
+// The host has no microphone, effects see silence when sound control is on
+
+namespace {
+
+    Spectrometer* object = nullptr;
+
+} // namespace
+
+Spectrometer* Spectrometer::instance()
+{
+    return object;
+}
+
+void Spectrometer::Initialize()
+{
+    if (object) {
+        return;
+    }
+
+    object = new Spectrometer();
+}
+
+void Spectrometer::loop()
+{
+}
+
+Spectrometer::eqBand Spectrometer::band(uint8_t i)
+{
+    return {};
+}
+
+uint8_t Spectrometer::asHue()
+{
+    return 0;
+}
+
+Spectrometer::Spectrometer()
+{
+}
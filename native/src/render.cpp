@@ -0,0 +1,164 @@
+// Renders effects on the host at any matrix size, see README
+//
+//   render [-w width] [-h height] [-n frames] [-s seed] [-o dir] [-g] [effect id...]
+//
+// Every effect (all registered ones by default) is started fresh, ticked
+// frames times with its own frame interval and timed. Prints the average
+// tick time in ns/frame and the hash of the last frame, with -o all frames
+// go to <dir>/<id>.ppm as one binary PPM after another in matrix coordinates.
+// -g prints the hashes of every frame instead, as the golden header of the
+// host frame test.
+#ifndef PIO_UNIT_TESTING
+
+#include "EffectFactories.h"
+#include "HostRender.h"
+#include "MyMatrix.h"
+#include "Settings.h"
+
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+    void usage()
+    {
+        fprintf(stderr, "usage: render [-w width] [-h height] [-n frames] [-s seed] [-o dir] [-g] [effect id...]\n");
+    }
+
+    void writeFrame(FILE* file, const CRGB* buffer)
+    {
+        const int16_t width = myMatrix->width();
+        const int16_t height = myMatrix->height();
+        fprintf(file, "P6\n%d %d\n255\n", width, height);
+        for (int16_t y = 0; y < height; ++y) {
+            for (int16_t x = 0; x < width; ++x) {
+                fwrite(buffer[myMatrix->XY(x, y)].raw, 1, 3, file);
+            }
+        }
+    }
+
+    bool render(uint8_t factory, uint16_t frames, uint32_t seed, const char* dir)
+    {
+        const String id = EffectFactories::id(factory);
+        FILE* file = nullptr;
+        if (dir) {
+            const String path = String(dir) + "/" + id + ".ppm";
+            file = fopen(path.c_str(), "wb");
+            if (!file) {
+                fprintf(stderr, "can't write %s\n", path.c_str());
+                return false;
+            }
+        }
+
+        uint32_t hash = 0;
+        const uint64_t elapsed = renderEffect(factory, frames, seed, [&](uint16_t frame, const CRGB* leds) {
+            hash = MyMatrix::hashFrame(leds);
+            if (file) {
+                writeFrame(file, leds);
+            }
+        });
+
+        printf("%-20s %10llu ns/frame  %08x\n", id.c_str(),
+            static_cast<unsigned long long>(frames > 0 ? elapsed / frames : 0), hash);
+        if (file) {
+            fclose(file);
+        }
+        return true;
+    }
+
+    void printGolden(const std::vector<uint8_t>& factories, uint16_t frames, uint32_t seed)
+    {
+        const uint8_t width = mySettings->matrixSettings.width;
+        const uint8_t height = mySettings->matrixSettings.height;
+        printf("#pragma once\n");
+        printf("// Frame hashes of every effect on the host, generated by\n");
+        printf("// .pio/build/native/program -w %u -h %u -n %u -s %u -g, see README\n\n", width, height, frames, seed);
+        printf("#include <stdint.h>\n\n");
+        printf("const uint8_t goldenWidth = %u;\n", width);
+        printf("const uint8_t goldenHeight = %u;\n", height);
+        printf("const uint32_t goldenSeed = %u;\n", seed);
+        printf("const uint16_t goldenFrames = %u;\n\n", frames);
+        printf("struct GoldenFrames\n{\n    const char* id;\n    uint32_t hashes[%u];\n};\n\n", frames);
+        printf("const GoldenFrames golden[] = {\n");
+        for (uint8_t factory : factories) {
+            printf("    {\"%s\", {", EffectFactories::id(factory).c_str());
+            renderEffect(factory, frames, seed, [&](uint16_t frame, const CRGB* leds) {
+                printf("%s0x%08x", frame > 0 ? ", " : "", MyMatrix::hashFrame(leds));
+            });
+            printf("}},\n");
+        }
+        printf("};\n");
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Settings::Initialize();
+
+    uint16_t frames = 100;
+    uint32_t seed = 1;
+    const char* dir = nullptr;
+    bool golden = false;
+    std::vector<uint8_t> factories;
+    for (int i = 1; i < argc; ++i) {
+        const String arg = argv[i];
+        if (arg == "-g") {
+            golden = true;
+            continue;
+        }
+        if (arg.startsWith("-") && arg.length() == 2 && i + 1 < argc) {
+            const char* value = argv[++i];
+            switch (arg[1]) {
+            case 'w':
+                mySettings->matrixSettings.width = atoi(value);
+                continue;
+            case 'h':
+                mySettings->matrixSettings.height = atoi(value);
+                continue;
+            case 'n':
+                frames = atoi(value);
+                continue;
+            case 's':
+                seed = strtoul(value, nullptr, 0);
+                continue;
+            case 'o':
+                dir = value;
+                continue;
+            }
+            usage();
+            return 2;
+        }
+        const uint8_t factory = EffectFactories::find(arg);
+        if (factory == EffectFactories::count()) {
+            fprintf(stderr, "unknown effect %s\n", argv[i]);
+            return 2;
+        }
+        factories.push_back(factory);
+    }
+    if (mySettings->matrixSettings.width == 0 || mySettings->matrixSettings.height == 0) {
+        usage();
+        return 2;
+    }
+    if (factories.empty()) {
+        for (uint8_t factory = 0; factory < EffectFactories::count(); ++factory) {
+            factories.push_back(factory);
+        }
+    }
+
+    MyMatrix::Initialize();
+    if (golden) {
+        printGolden(factories, frames, seed);
+        return 0;
+    }
+    printf("%ux%u, %u frames, seed %u\n", mySettings->matrixSettings.width, mySettings->matrixSettings.height,
+        frames, seed);
+    for (uint8_t factory : factories) {
+        if (!render(factory, frames, seed, dir)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include "EffectArena.h"
+#include "Settings.h"
+
+namespace {
+
+    // keeps heap fallbacks aligned for any type
+    const size_t overflowHeader = 8;
+    const size_t minSlotSize = 1536;
+
+    EffectArena slots[EffectArena::slotsCount];
+    size_t arenaSlotSize = 0;
+
+    void setupSlots()
+    {
+        // Fractional effects keep a CRGB frame plus a noise layer, with row
+        // pointers for the jagged arrays. Lighters need a fixed 1.3 KB.
+        const uint16_t width = mySettings->matrixSettings.width;
+        const uint16_t height = mySettings->matrixSettings.height;
+        arenaSlotSize = width * height * 4 + (width + height) * 2 * sizeof(void*) + 512;
+        if (arenaSlotSize < minSlotSize) {
+            arenaSlotSize = minSlotSize;
+        }
+#ifdef USE_DEBUG
+        Serial.printf_P(PSTR("Effect arena: %u x %u bytes\n"), EffectArena::slotsCount, arenaSlotSize);
+#endif
+    }
+
+} // namespace
+
+EffectArena* EffectArena::acquire()
+{
+    if (arenaSlotSize == 0) {
+        setupSlots();
+    }
+    for (EffectArena& slot : slots) {
+        if (slot.busy) {
+            continue;
+        }
+        if (!slot.buffer) {
+            slot.buffer = new uint8_t[arenaSlotSize];
+            slot.capacity = arenaSlotSize;
+        }
+        slot.busy = true;
+        return &slot;
+    }
+    // offscreen renders can activate a third effect during a crossfade
+    EffectArena* arena = new EffectArena();
+    arena->busy = true;
+    arena->dynamic = true;
+    return arena;
+}
+
+void EffectArena::release()
+{
+    while (overflow) {
+        void* next = *static_cast<void**>(overflow);
+        free(overflow);
+        overflow = next;
+    }
+    offset = 0;
+    overflowBytes = 0;
+    busy = false;
+    if (dynamic) {
+        delete this;
+    }
+}
+
+void* EffectArena::allocateBytes(size_t bytes, size_t alignment)
+{
+    const size_t start = (offset + alignment - 1) & ~(alignment - 1);
+    if (start + bytes <= capacity) {
+        offset = start + bytes;
+        memset(buffer + start, 0, bytes);
+        return buffer + start;
+    }
+
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Effect arena full, %u bytes from heap\n"), bytes);
+#endif
+    uint8_t* block = static_cast<uint8_t*>(calloc(1, overflowHeader + bytes));
+    if (!block) {
+        return nullptr;
+    }
+    *reinterpret_cast<void**>(block) = overflow;
+    overflow = block;
+    overflowBytes += bytes;
+    return block + overflowHeader;
+}
+
+size_t EffectArena::used() const
+{
+    return offset + overflowBytes;
+}
+
+size_t EffectArena::slotSize()
+{
+    return arenaSlotSize;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <Arduino.h>
+
+// Memory for the buffers an effect sets up in activate(). Blocks are carved
+// from buffers allocated once, sized from the matrix, and all of them are
+// dropped together when the effect is deactivated, so switching effects
+// doesn't fragment the heap. Requests that don't fit fall back to the heap
+// and are freed together with the rest.
+class EffectArena
+{
+public:
+    // the outgoing and the incoming effect are both active during a crossfade
+    static const uint8_t slotsCount = 2;
+
+    // Arena for an effect being activated, heap only if all slots are taken
+    static EffectArena *acquire();
+    void release();
+
+    // Zeroed memory for count items of T, valid until release()
+    template <typename T>
+    T *allocate(size_t count)
+    {
+        return static_cast<T *>(allocateBytes(count * sizeof(T), alignof(T)));
+    }
+
+    // Bytes handed out since acquire(), heap fallbacks included
+    size_t used() const;
+    static size_t slotSize();
+
+private:
+    void *allocateBytes(size_t bytes, size_t alignment);
+
+    uint8_t *buffer = nullptr;
+    size_t capacity = 0;
+    size_t offset = 0;
+    size_t overflowBytes = 0;
+    // heap blocks, each starts with the pointer to the next one
+    void *overflow = nullptr;
+    bool busy = false;
+    bool dynamic = false;
+};
@@ -0,0 +1,35 @@
+#include "EffectClock.h"
+#include <FastLED.h>
+
+namespace {
+
+    bool held = false;
+    uint32_t heldMillis = 0;
+
+} // namespace
+
+uint32_t EffectClock::now()
+{
+    return held ? heldMillis : millis();
+}
+
+void EffectClock::hold(uint32_t ms)
+{
+    heldMillis = ms;
+    held = true;
+}
+
+void EffectClock::advance(uint32_t ms)
+{
+    heldMillis += ms;
+}
+
+void EffectClock::release()
+{
+    held = false;
+}
+
+uint32_t get_millisecond_timer()
+{
+    return EffectClock::now();
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <Arduino.h>
+
+// Time effects animate by. It follows millis() while the lamp runs; offscreen
+// renders hold it and step it by the frame interval, so a seeded render
+// draws the same frames however long each tick really takes.
+// FastLED's beatsin and EVERY_N_* timers read it too, through
+// get_millisecond_timer() (USE_GET_MILLISECOND_TIMER in platformio.ini).
+namespace EffectClock {
+
+uint32_t now();
+
+// Stops following millis(), now() returns ms until advanced or released
+void hold(uint32_t ms = 0);
+void advance(uint32_t ms);
+void release();
+
+} // namespace EffectClock
@@ -0,0 +1,245 @@
+#include "EffectFactories.h"
+
+#include "effects/basic/SparklesEffect.h"
+#include "effects/basic/FireEffect.h"
+#include "effects/basic/MatrixEffect.h"
+#include "effects/basic/VerticalRainbowEffect.h"
+#include "effects/basic/HorizontalRainbowEffect.h"
+#include "effects/basic/ColorEffect.h"
+#include "effects/basic/ColorsEffect.h"
+#include "effects/basic/SnowEffect.h"
+#include "effects/basic/LightersEffect.h"
+// #include "effects/basic/ClockEffect.h"
+// #include "effects/basic/ClockHorizontal1Effect.h"
+// #include "effects/basic/ClockHorizontal2Effect.h"
+// #include "effects/basic/ClockHorizontal3Effect.h"
+#include "effects/basic/StarfallEffect.h"
+#include "effects/basic/DiagonalRainbowEffect.h"
+
+// #include "effects/noise/MadnessNoiseEffect.h"
+// #include "effects/noise/CloudNoiseEffect.h"
+// #include "effects/noise/LavaNoiseEffect.h"
+// #include "effects/noise/PlasmaNoiseEffect.h"
+// #include "effects/noise/RainbowNoiseEffect.h"
+// #include "effects/noise/RainbowStripeNoiseEffect.h"
+// #include "effects/noise/ZebraNoiseEffect.h"
+// #include "effects/noise/ForestNoiseEffect.h"
+// #include "effects/noise/OceanNoiseEffect.h"
+
+// #include "effects/sound/SoundEffect.h"
+// #include "effects/sound/SoundStereoEffect.h"
+
+#include "effects/basic/WaterfallEffect.h"
+#include "effects/basic/TwirlRainbowEffect.h"
+#include "effects/basic/PulseCirclesEffect.h"
+// #include "effects/basic/AnimationEffect.h"
+#include "effects/basic/StormEffect.h"
+#include "effects/basic/Matrix2Effect.h"
+#include "effects/basic/TrackingLightersEffect.h"
+#include "effects/basic/LightBallsEffect.h"
+#include "effects/basic/MovingCubeEffect.h"
+#include "effects/basic/WhiteColorEffect.h"
+
+#include "effects/fractional/PulsingCometEffect.h"
+#include "effects/fractional/DoubleCometsEffect.h"
+#include "effects/fractional/TripleCometsEffect.h"
+#include "effects/fractional/RainbowCometEffect.h"
+#include "effects/fractional/ColorCometEffect.h"
+#include "effects/fractional/MovingFlameEffect.h"
+#include "effects/fractional/FractorialFireEffect.h"
+#include "effects/fractional/RainbowKiteEffect.h"
+
+#include "effects/basic/BouncingBallsEffect.h"
+#include "effects/basic/SpiralEffect.h"
+#include "effects/basic/MetaBallsEffect.h"
+#include "effects/basic/SinusoidEffect.h"
+#include "effects/basic/WaterfallPaletteEffect.h"
+#include "effects/basic/RainEffect.h"
+#include "effects/basic/PrismataEffect.h"
+
+#include "effects/aurora/FlockEffect.h"
+#include "effects/aurora/WhirlEffect.h"
+#include "effects/aurora/WaveEffect.h"
+
+// #include "effects/basic/Fire12Effect.h"
+// #include "effects/basic/Fire18Effect.h"
+// #include "effects/basic/RainNeoEffect.h"
+// #include "effects/basic/TwinklesEffect.h"
+
+// #include "effects/network/DMXEffect.h"
+
+// #include "effects/basic/ScrollingTextEffect.h"
+
+namespace {
+
+    template <typename T>
+    Effect* createEffect(const String& id)
+    {
+        return new T(id);
+    }
+
+    struct EffectFactory {
+        const char* id;
+        Effect* (*create)(const String& id);
+    };
+
+    const char SparklesEffectId[] PROGMEM = "Sparkles";
+    const char FireEffectId[] PROGMEM = "Fire";
+    const char VerticalRainbowEffectId[] PROGMEM = "VerticalRainbow";
+    const char HorizontalRainbowEffectId[] PROGMEM = "HorizontalRainbow";
+    const char ColorsEffectId[] PROGMEM = "Colors";
+    // const char MadnessNoiseEffectId[] PROGMEM = "MadnessNoise";
+    // const char CloudNoiseEffectId[] PROGMEM = "CloudNoise";
+    // const char LavaNoiseEffectId[] PROGMEM = "LavaNoise";
+    // const char PlasmaNoiseEffectId[] PROGMEM = "PlasmaNoise";
+    // const char RainbowNoiseEffectId[] PROGMEM = "RainbowNoise";
+    // const char RainbowStripeNoiseEffectId[] PROGMEM = "RainbowStripeNoise";
+    // const char ZebraNoiseEffectId[] PROGMEM = "ZebraNoise";
+    // const char ForestNoiseEffectId[] PROGMEM = "ForestNoise";
+    // const char OceanNoiseEffectId[] PROGMEM = "OceanNoise";
+    const char ColorEffectId[] PROGMEM = "Color";
+    const char SnowEffectId[] PROGMEM = "Snow";
+    const char MatrixEffectId[] PROGMEM = "Matrix";
+    const char LightersEffectId[] PROGMEM = "Lighters";
+    // const char ClockEffectId[] PROGMEM = "Clock";
+    // const char ClockHorizontal1EffectId[] PROGMEM = "ClockHorizontal1";
+    // const char ClockHorizontal2EffectId[] PROGMEM = "ClockHorizontal2";
+    // const char ClockHorizontal3EffectId[] PROGMEM = "ClockHorizontal3";
+    const char StarfallEffectId[] PROGMEM = "Starfall";
+    const char DiagonalRainbowEffectId[] PROGMEM = "DiagonalRainbow";
+    const char WaterfallEffectId[] PROGMEM = "Waterfall";
+    const char TwirlRainbowEffectId[] PROGMEM = "TwirlRainbow";
+    const char PulseCirclesEffectId[] PROGMEM = "PulseCircles";
+    // const char AnimationEffectId[] PROGMEM = "Animation";
+    const char StormEffectId[] PROGMEM = "Storm";
+    const char Matrix2EffectId[] PROGMEM = "Matrix2";
+    const char TrackingLightersEffectId[] PROGMEM = "TrackingLighters";
+    const char LightBallsEffectId[] PROGMEM = "LightBalls";
+    const char MovingCubeEffectId[] PROGMEM = "MovingCube";
+    const char WhiteColorEffectId[] PROGMEM = "WhiteColor";
+    const char PulsingCometEffectId[] PROGMEM = "PulsingComet";
+    const char DoubleCometsEffectId[] PROGMEM = "DoubleComets";
+    const char TripleCometsEffectId[] PROGMEM = "TripleComets";
+    const char RainbowCometEffectId[] PROGMEM = "RainbowComet";
+    const char ColorCometEffectId[] PROGMEM = "ColorComet";
+    const char MovingFlameEffectId[] PROGMEM = "MovingFlame";
+    const char FractorialFireEffectId[] PROGMEM = "FractorialFire";
+    const char RainbowKiteEffectId[] PROGMEM = "RainbowKite";
+    const char BouncingBallsEffectId[] PROGMEM = "BouncingBalls";
+    const char SpiralEffectId[] PROGMEM = "Spiral";
+    const char MetaBallsEffectId[] PROGMEM = "MetaBalls";
+    const char SinusoidEffectId[] PROGMEM = "Sinusoid";
+    const char WaterfallPaletteEffectId[] PROGMEM = "WaterfallPalette";
+    const char RainEffectId[] PROGMEM = "Rain";
+    const char PrismataEffectId[] PROGMEM = "Prismata";
+    const char FlockEffectId[] PROGMEM = "Flock";
+    const char WhirlEffectId[] PROGMEM = "Whirl";
+    const char WaveEffectId[] PROGMEM = "Wave";
+    // const char Fire12EffectId[] PROGMEM = "Fire12";
+    // const char Fire18EffectId[] PROGMEM = "Fire18";
+    // const char RainNeoEffectId[] PROGMEM = "RainNeo";
+    // const char TwinklesEffectId[] PROGMEM = "Twinkles";
+    // const char SoundEffectId[] PROGMEM = "Sound";
+    // const char SoundStereoEffectId[] PROGMEM = "Stereo";
+    // const char DMXEffectId[] PROGMEM = "DMX";
+    // const char ScrollingTextEffectId[] PROGMEM = "Text";
+
+    // Effects are constructed from here when they are activated, so adding
+    // effects costs flash but no RAM
+    const EffectFactory effectFactories[] PROGMEM = {
+        { SparklesEffectId, createEffect<SparklesEffect> },
+        { FireEffectId, createEffect<FireEffect> },
+        { VerticalRainbowEffectId, createEffect<VerticalRainbowEffect> },
+        { HorizontalRainbowEffectId, createEffect<HorizontalRainbowEffect> },
+        { ColorsEffectId, createEffect<ColorsEffect> },
+        // { MadnessNoiseEffectId, createEffect<MadnessNoiseEffect> },
+        // { CloudNoiseEffectId, createEffect<CloudNoiseEffect> },
+        // { LavaNoiseEffectId, createEffect<LavaNoiseEffect> },
+        // { PlasmaNoiseEffectId, createEffect<PlasmaNoiseEffect> },
+        // { RainbowNoiseEffectId, createEffect<RainbowNoiseEffect> },
+        // { RainbowStripeNoiseEffectId, createEffect<RainbowStripeNoiseEffect> },
+        // { ZebraNoiseEffectId, createEffect<ZebraNoiseEffect> },
+        // { ForestNoiseEffectId, createEffect<ForestNoiseEffect> },
+        // { OceanNoiseEffectId, createEffect<OceanNoiseEffect> },
+        { ColorEffectId, createEffect<ColorEffect> },
+        { SnowEffectId, createEffect<SnowEffect> },
+        { MatrixEffectId, createEffect<MatrixEffect> },
+        { LightersEffectId, createEffect<LightersEffect> },
+        // { ClockEffectId, createEffect<ClockEffect> },
+        // { ClockHorizontal1EffectId, createEffect<ClockHorizontal1Effect> },
+        // { ClockHorizontal2EffectId, createEffect<ClockHorizontal2Effect> },
+        // { ClockHorizontal3EffectId, createEffect<ClockHorizontal3Effect> },
+        { StarfallEffectId, createEffect<StarfallEffect> },
+        { DiagonalRainbowEffectId, createEffect<DiagonalRainbowEffect> },
+        { WaterfallEffectId, createEffect<WaterfallEffect> },
+        { TwirlRainbowEffectId, createEffect<TwirlRainbowEffect> },
+        { PulseCirclesEffectId, createEffect<PulseCirclesEffect> },
+        // { AnimationEffectId, createEffect<AnimationEffect> },
+        { StormEffectId, createEffect<StormEffect> },
+        { Matrix2EffectId, createEffect<Matrix2Effect> },
+        { TrackingLightersEffectId, createEffect<TrackingLightersEffect> },
+        { LightBallsEffectId, createEffect<LightBallsEffect> },
+        { MovingCubeEffectId, createEffect<MovingCubeEffect> },
+        { WhiteColorEffectId, createEffect<WhiteColorEffect> },
+        { PulsingCometEffectId, createEffect<PulsingCometEffect> },
+        { DoubleCometsEffectId, createEffect<DoubleCometsEffect> },
+        { TripleCometsEffectId, createEffect<TripleCometsEffect> },
+        { RainbowCometEffectId, createEffect<RainbowCometEffect> },
+        { ColorCometEffectId, createEffect<ColorCometEffect> },
+        { MovingFlameEffectId, createEffect<MovingFlameEffect> },
+        { FractorialFireEffectId, createEffect<FractorialFireEffect> },
+        { RainbowKiteEffectId, createEffect<RainbowKiteEffect> },
+        { BouncingBallsEffectId, createEffect<BouncingBallsEffect> },
+        { SpiralEffectId, createEffect<SpiralEffect> },
+        { MetaBallsEffectId, createEffect<MetaBallsEffect> },
+        { SinusoidEffectId, createEffect<SinusoidEffect> },
+        { WaterfallPaletteEffectId, createEffect<WaterfallPaletteEffect> },
+        { RainEffectId, createEffect<RainEffect> },
+        { PrismataEffectId, createEffect<PrismataEffect> },
+        { FlockEffectId, createEffect<FlockEffect> },
+        { WhirlEffectId, createEffect<WhirlEffect> },
+        { WaveEffectId, createEffect<WaveEffect> },
+        // { Fire12EffectId, createEffect<Fire12Effect> },
+        // { Fire18EffectId, createEffect<Fire18Effect> },
+        // { RainNeoEffectId, createEffect<RainNeoEffect> },
+        // { TwinklesEffectId, createEffect<TwinklesEffect> },
+        // { SoundEffectId, createEffect<SoundEffect> },
+        // { SoundStereoEffectId, createEffect<SoundStereoEffect> },
+        // { DMXEffectId, createEffect<DMXEffect> },
+        // { ScrollingTextEffectId, createEffect<ScrollingTextEffect> },
+    };
+
+    const uint8_t factoriesCount = sizeof(effectFactories) / sizeof(effectFactories[0]);
+
+    EffectFactory factoryAt(uint8_t index)
+    {
+        EffectFactory factory;
+        memcpy_P(&factory, &effectFactories[index], sizeof(factory));
+        return factory;
+    }
+
+} // namespace
+
+uint8_t EffectFactories::count()
+{
+    return factoriesCount;
+}
+
+uint8_t EffectFactories::find(const String& id)
+{
+    uint8_t factory = 0;
+    while (factory < factoriesCount && strcmp_P(id.c_str(), factoryAt(factory).id) != 0) {
+        ++factory;
+    }
+    return factory;
+}
+
+String EffectFactories::id(uint8_t index)
+{
+    return String(FPSTR(factoryAt(index).id));
+}
+
+Effect* EffectFactories::create(uint8_t index, const String& id)
+{
+    return factoryAt(index).create(id);
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <Arduino.h>
+#include "effects/Effect.h"
+
+// Every effect the firmware can run, by id. The table lives in flash and
+// an effect is only constructed when it is activated or rendered.
+class EffectFactories
+{
+public:
+    static uint8_t count();
+    // Index of the effect with this id, count() if there is none
+    static uint8_t find(const String &id);
+    static String id(uint8_t index);
+    static Effect *create(uint8_t index, const String &id);
+};
@@ -2,88 +2,377 @@
 #include "Settings.h"
 #include "MqttClient.h"
 #include "LampWebServer.h"
+#include "EffectFactories.h"
+#include "EffectClock.h"
 
-#include "effects/basic/SparklesEffect.h"
-#include "effects/basic/FireEffect.h"
-#include "effects/basic/MatrixEffect.h"
-#include "effects/basic/VerticalRainbowEffect.h"
-#include "effects/basic/HorizontalRainbowEffect.h"
-#include "effects/basic/ColorEffect.h"
-#include "effects/basic/ColorsEffect.h"
-#include "effects/basic/SnowEffect.h"
-#include "effects/basic/LightersEffect.h"
-// #include "effects/basic/ClockEffect.h"
-// #include "effects/basic/ClockHorizontal1Effect.h"
-// #include "effects/basic/ClockHorizontal2Effect.h"
-// #include "effects/basic/ClockHorizontal3Effect.h"
-#include "effects/basic/StarfallEffect.h"
-#include "effects/basic/DiagonalRainbowEffect.h"
-
-// #include "effects/noise/MadnessNoiseEffect.h"
-// #include "effects/noise/CloudNoiseEffect.h"
-// #include "effects/noise/LavaNoiseEffect.h"
-// #include "effects/noise/PlasmaNoiseEffect.h"
-// #include "effects/noise/RainbowNoiseEffect.h"
-// #include "effects/noise/RainbowStripeNoiseEffect.h"
-// #include "effects/noise/ZebraNoiseEffect.h"
-// #include "effects/noise/ForestNoiseEffect.h"
-// #include "effects/noise/OceanNoiseEffect.h"
-
-// #include "effects/sound/SoundEffect.h"
-// #include "effects/sound/SoundStereoEffect.h"
-
-#include "effects/basic/WaterfallEffect.h"
-#include "effects/basic/TwirlRainbowEffect.h"
-#include "effects/basic/PulseCirclesEffect.h"
-// #include "effects/basic/AnimationEffect.h"
-#include "effects/basic/StormEffect.h"
-#include "effects/basic/Matrix2Effect.h"
-#include "effects/basic/TrackingLightersEffect.h"
-#include "effects/basic/LightBallsEffect.h"
-#include "effects/basic/MovingCubeEffect.h"
-#include "effects/basic/WhiteColorEffect.h"
-
-#include "effects/fractional/PulsingCometEffect.h"
-#include "effects/fractional/DoubleCometsEffect.h"
-#include "effects/fractional/TripleCometsEffect.h"
-#include "effects/fractional/RainbowCometEffect.h"
-#include "effects/fractional/ColorCometEffect.h"
-#include "effects/fractional/MovingFlameEffect.h"
-#include "effects/fractional/FractorialFireEffect.h"
-#include "effects/fractional/RainbowKiteEffect.h"
-
-#include "effects/basic/BouncingBallsEffect.h"
-#include "effects/basic/SpiralEffect.h"
-#include "effects/basic/MetaBallsEffect.h"
-#include "effects/basic/SinusoidEffect.h"
-#include "effects/basic/WaterfallPaletteEffect.h"
-#include "effects/basic/RainEffect.h"
-#include "effects/basic/PrismataEffect.h"
-
-#include "effects/aurora/FlockEffect.h"
-#include "effects/aurora/WhirlEffect.h"
-#include "effects/aurora/WaveEffect.h"
-
-// #include "effects/basic/Fire12Effect.h"
-// #include "effects/basic/Fire18Effect.h"
-// #include "effects/basic/RainNeoEffect.h"
-// #include "effects/basic/TwinklesEffect.h"
-
-// #include "effects/network/DMXEffect.h"
-
-// #include "effects/basic/ScrollingTextEffect.h"
-
-#include <map>
+#if defined(ESP32)
+#include <atomic>
+#ifdef USE_PROFILER
+#include <esp_task_wdt.h>
+#endif
+#endif
 
 namespace {
 
     EffectsManager* object = nullptr;
 
-    std::map<String, Effect*> effectsMap;
+    // Extra settings of one effect, serialized into EffectRecord::extra
+    const size_t extraJsonSize = 512;
+
+    Effect* createInstance(EffectRecord& record)
+    {
+        Effect* effect = EffectFactories::create(record.factory, record.settings.id);
+        if (record.extra.length() > 0) {
+            DynamicJsonDocument doc(extraJsonSize);
+            deserializeJson(doc, record.extra);
+            effect->initialize(doc.as<JsonObject>());
+        }
+        // common settings win over same named effect specific ones
+        effect->settings = record.settings;
+        effect->stats = &record.stats;
+        return effect;
+    }
+
+    void saveInstance(Effect* effect, EffectRecord& record)
+    {
+        record.settings = effect->settings;
+        DynamicJsonDocument doc(extraJsonSize);
+        JsonObject json = doc.to<JsonObject>();
+        effect->writeSettings(json);
+        record.extra = String();
+        if (json.size() > 0) {
+            serializeJson(doc, record.extra);
+        }
+    }
+
+    void releaseInstance(Effect* effect, EffectRecord& record)
+    {
+        saveInstance(effect, record);
+        delete effect;
+    }
+
+    // Settings json for an effect that is not instantiated, a short lived
+    // instance parses it including the effect specific keys
+    void applySettings(EffectRecord& record, const JsonObject& json)
+    {
+        Effect* effect = createInstance(record);
+        effect->initialize(json);
+        releaseInstance(effect, record);
+    }
 
-    uint32_t effectTimer = 0;
+    FrameScheduler scheduler;
 
     uint8_t activeIndex = 0;
+    // instance of the effect at activeIndex, created on demand
+    Effect* activeInstance = nullptr;
+    // false until the effect at activeIndex had start() called
+    bool effectActive = false;
+
+    // True if applying json changes the id or name of settings
+    bool renames(const Settings::EffectSettings& settings, const JsonObject& json)
+    {
+        const char* id = json[F("i")];
+        // "name" wins over "n" in Effect::update()
+        const char* name = json[F("name")];
+        if (!name) {
+            name = json[F("n")];
+        }
+        return (id && settings.id != id) || (name && settings.name != name);
+    }
+
+    uint32_t hashKey(const char* key)
+    {
+        uint32_t hash = 2166136261u;
+        while (*key) {
+            hash = (hash ^ static_cast<uint8_t>(*key++)) * 16777619u;
+        }
+        return hash;
+    }
+
+    // Open addressing table from the hash of an effect id or name to the
+    // effect index, so MQTT and web commands don't scan the list
+    struct EffectLookup
+    {
+        // effect index + 1, 0 - empty slot
+        std::vector<uint8_t> slots;
+        std::vector<uint32_t> hashes;
+
+        void reset(size_t count)
+        {
+            // at most half full keeps probe chains short
+            size_t size = 8;
+            while (size < count * 2) {
+                size <<= 1;
+            }
+            slots.assign(size, 0);
+            hashes.assign(size, 0);
+        }
+
+        void insert(const char* key, uint8_t index)
+        {
+            const uint32_t hash = hashKey(key);
+            const size_t mask = slots.size() - 1;
+            size_t slot = hash & mask;
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = index + 1;
+            hashes[slot] = hash;
+        }
+
+        // Duplicates are found in insertion order, same as a linear scan
+        int16_t find(const String& key, bool byName) const
+        {
+            if (slots.empty()) {
+                return -1;
+            }
+            const uint32_t hash = hashKey(key.c_str());
+            const size_t mask = slots.size() - 1;
+            for (size_t slot = hash & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+                if (hashes[slot] != hash) {
+                    continue;
+                }
+                const uint8_t index = slots[slot] - 1;
+                const Settings::EffectSettings& settings = effectsManager->effects[index].settings;
+                if ((byName ? settings.name : settings.id) == key) {
+                    return index;
+                }
+            }
+            return -1;
+        }
+    };
+
+    EffectLookup idLookup;
+    EffectLookup nameLookup;
+    // ids and names change when effects are loaded or renamed
+    bool lookupValid = false;
+
+    // Callers hold the render lock
+    int16_t findEffect(const String& key, bool byName)
+    {
+        if (!lookupValid) {
+            const uint8_t count = effectsManager->count();
+            idLookup.reset(count);
+            nameLookup.reset(count);
+            for (uint8_t index = 0; index < count; ++index) {
+                const Settings::EffectSettings& settings = effectsManager->effects[index].settings;
+                idLookup.insert(settings.id.c_str(), index);
+                nameLookup.insert(settings.name.c_str(), index);
+            }
+            lookupValid = true;
+        }
+        return (byName ? nameLookup : idLookup).find(key, byName);
+    }
+
+
+    enum TransitionMode : uint8_t {
+        TransitionNone = 0,
+        TransitionLinear = 1,
+        TransitionGamma = 2
+    };
+
+    // Heap left over for the incoming effect's own buffers before
+    // crossfade falls back to fading through black
+    const size_t transitionHeapReserve = 4096;
+
+    bool transitioning = false;
+    bool crossfade = false;
+    Effect* outgoingEffect = nullptr;
+    uint8_t outgoingIndex = 0;
+    bool outgoingActive = false;
+    uint8_t outgoingRotation = 0;
+    uint8_t incomingRotation = 0;
+    uint8_t transitionFrame = 0;
+    uint8_t transitionFrames = 0;
+    CRGB* outgoingBuffer = nullptr;
+    CRGB* incomingBuffer = nullptr;
+
+    size_t maxAllocatableHeap()
+    {
+#if defined(ESP32)
+        return ESP.getMaxAllocHeap();
+#else
+        return ESP.getMaxFreeBlockSize();
+#endif
+    }
+
+    uint8_t blendGamma(uint8_t from, uint8_t to, uint8_t amount)
+    {
+        // mix in (roughly) linear light using gamma 2.0
+        const uint16_t mixed = scale16by8(from * from, 255 - amount) + scale16by8(to * to, amount);
+        return sqrt16(mixed);
+    }
+
+    void blendFrames(CRGB* out, uint8_t amount, bool gammaCorrect)
+    {
+        const uint16_t numLeds = myMatrix->getNumLeds();
+        for (uint16_t i = 0; i < numLeds; ++i) {
+            if (gammaCorrect) {
+                out[i].r = blendGamma(outgoingBuffer[i].r, incomingBuffer[i].r, amount);
+                out[i].g = blendGamma(outgoingBuffer[i].g, incomingBuffer[i].g, amount);
+                out[i].b = blendGamma(outgoingBuffer[i].b, incomingBuffer[i].b, amount);
+            }
+            else {
+                out[i] = blend(outgoingBuffer[i], incomingBuffer[i], amount);
+            }
+        }
+    }
+
+    void renderInto(CRGB* buffer, Effect* effect, uint8_t rotation, uint32_t dt)
+    {
+        if (myMatrix->getRotation() != rotation) {
+            myMatrix->setRotation(rotation);
+        }
+        myMatrix->setDrawBuffer(buffer);
+        effect->tick(dt);
+        myMatrix->setDrawBuffer(nullptr);
+    }
+
+#if defined(ESP32)
+    const uint32_t renderTaskStackSize = 8192;
+    const UBaseType_t renderTaskPriority = 2;
+    const BaseType_t renderTaskCore = 1;
+
+    enum CommandType : uint8_t {
+        CommandActivate,
+        CommandNext,
+        CommandPrevious,
+        CommandUpdate,
+        CommandUpdateActive,
+        CommandBrightness
+    };
+
+    struct Command {
+        CommandType type;
+        // effect index, the brightness for CommandBrightness
+        uint8_t index;
+        bool save;
+        // serialized settings of the update commands, freed by the receiver
+        String* json;
+    };
+
+    // Web socket and MQTT handlers push from the async tcp task, button
+    // from the service task, the render task takes them between frames
+    const UBaseType_t commandsLength = 16;
+    // A frame or two, the queue only fills up while the render task is stuck
+    const TickType_t commandTimeout = pdMS_TO_TICKS(100);
+    // Same as the mqtt command document
+    const size_t commandJsonSize = 1024;
+    QueueHandle_t commands = nullptr;
+    std::atomic<uint32_t> dropped(0);
+
+    TaskHandle_t renderTaskHandle = nullptr;
+    void (*renderCallback)() = nullptr;
+    // Held by the render task while it switches effects, which deletes
+    // instances and publishes their settings into the records. Other tasks
+    // hold it to read the records, see RenderLock. Recursive, as accessors
+    // call each other.
+    SemaphoreHandle_t renderMutex = nullptr;
+    // Held by the render task for a whole pass including tick and show,
+    // other tasks hold it to borrow the matrix, see FrameLock
+    SemaphoreHandle_t frameMutex = nullptr;
+
+    void renderTask(void* parameter)
+    {
+        for (;;) {
+            xSemaphoreTake(frameMutex, portMAX_DELAY);
+            xSemaphoreTakeRecursive(renderMutex, portMAX_DELAY);
+            effectsManager->processCommands();
+            xSemaphoreGiveRecursive(renderMutex);
+            renderCallback();
+            xSemaphoreGive(frameMutex);
+            vTaskDelay(1);
+        }
+    }
+
+    // Returns true if the command was handed over to the render task and
+    // should not be executed by the caller. Callers must not hold the render
+    // lock, the render task takes it to empty the queue.
+    bool queueCommand(CommandType type, uint8_t index = 0, bool save = false, const JsonObject* json = nullptr)
+    {
+        if (!renderTaskHandle || xTaskGetCurrentTaskHandle() == renderTaskHandle) {
+            return false;
+        }
+
+        Command command = { type, index, save, nullptr };
+        if (json) {
+            command.json = new String();
+            serializeJson(*json, *command.json);
+        }
+        if (xQueueSend(commands, &command, commandTimeout) != pdTRUE) {
+            ++dropped;
+            delete command.json;
+#ifdef USE_DEBUG
+            Serial.printf_P(PSTR("Render command queue is full, dropping command %u\n"), type);
+#endif
+        }
+        return true;
+    }
+
+    // Mqtt, web server and settings are not thread safe, changes made by
+    // the render task are announced from the service task
+    std::atomic<bool> notifyPending(false);
+    std::atomic<bool> savePending(false);
+#endif
+
+    // Scope in which the running instances can't be switched away under
+    // the caller, nothing to do without a render task
+    struct RenderLock
+    {
+        RenderLock()
+        {
+#if defined(ESP32)
+            xSemaphoreTakeRecursive(renderMutex, portMAX_DELAY);
+#endif
+        }
+
+        ~RenderLock()
+        {
+#if defined(ESP32)
+            xSemaphoreGiveRecursive(renderMutex);
+#endif
+        }
+    };
+
+    // Scope in which the render task draws nothing, so the matrix and the
+    // file scope state of effects can be borrowed. Taken before RenderLock,
+    // never inside it.
+    struct FrameLock
+    {
+        FrameLock()
+        {
+#if defined(ESP32)
+            xSemaphoreTake(frameMutex, portMAX_DELAY);
+#endif
+        }
+
+        ~FrameLock()
+        {
+#if defined(ESP32)
+            xSemaphoreGive(frameMutex);
+#endif
+        }
+    };
+
+    void notifyChanged(bool save)
+    {
+#if defined(ESP32)
+        if (renderTaskHandle && xTaskGetCurrentTaskHandle() == renderTaskHandle) {
+            if (save) {
+                savePending = true;
+            }
+            notifyPending = true;
+            return;
+        }
+#endif
+        if (mqtt) {
+            mqtt->update();
+        }
+        lampWebServer->update();
+        if (save) {
+            mySettings->saveLater();
+        }
+    }
 
 } // namespace
 
@@ -108,7 +397,8 @@ void EffectsManager::processEffectSettings(const JsonObject& json)
 {
     const String effectId = json[F("i")].as<String>();
 
-    if (effectsMap.count(effectId) <= 0) {
+    const uint8_t factory = EffectFactories::find(effectId);
+    if (factory == EffectFactories::count()) {
 #ifdef USE_DEBUG
         Serial.print(F("Missing effect: "));
         Serial.println(effectId);
@@ -116,16 +406,44 @@ void EffectsManager::processEffectSettings(const JsonObject& json)
         return;
     }
 
-    Effect* effect = effectsMap[effectId];
-    effects.push_back(effect);
-    effect->initialize(json);
+    EffectRecord record;
+    record.factory = factory;
+    record.settings.id = effectId;
+    record.settings.name = effectId;
+    applySettings(record, json);
+    effects.push_back(record);
+    lookupValid = false;
+}
+
+void EffectsManager::addEffect(const Settings::EffectSettings& settings, const String& extra)
+{
+    const uint8_t factory = EffectFactories::find(settings.id);
+    if (factory == EffectFactories::count()) {
+#ifdef USE_DEBUG
+        Serial.print(F("Missing effect: "));
+        Serial.println(settings.id);
+#endif
+        return;
+    }
+
+    EffectRecord record;
+    record.factory = factory;
+    record.settings = settings;
+    record.extra = extra;
+    effects.push_back(record);
+    lookupValid = false;
 }
 
 void EffectsManager::processAllEffects()
 {
-    for (auto effectPair : effectsMap) {
-        effects.push_back(effectPair.second);
+    for (uint8_t factory = 0; factory < EffectFactories::count(); ++factory) {
+        EffectRecord record;
+        record.factory = factory;
+        record.settings.id = EffectFactories::id(factory);
+        record.settings.name = record.settings.id;
+        effects.push_back(record);
     }
+    lookupValid = false;
 }
 
 void EffectsManager::loop()
@@ -134,20 +452,314 @@ void EffectsManager::loop()
         return;
     }
 
-    if (effectTimer != 0 && (millis() - effectTimer) < (255 - activeEffect()->settings.speed)) {
-        if (mySettings->matrixSettings.dither) {
-            FastLED.show();
+    Effect* effect = activeEffect();
+    scheduler.setInterval(effect->frameInterval());
+    scheduler.setPolicy(effect->framePolicy());
+
+    const uint32_t now = millis();
+    const uint8_t frames = scheduler.framesDue(now);
+    if (frames == 0) {
+        myMatrix->refresh();
+        return;
+    }
+
+    if (transitioning) {
+        processTransition(scheduler.elapsed(now));
+        return;
+    }
+
+    effect->Process(scheduler.elapsed(now), frames);
+}
+
+bool EffectsManager::beginTransition(Effect* previousEffect, uint8_t previousIndex, Effect* effect)
+{
+    const uint8_t mode = mySettings->generalSettings.transitionMode;
+    const uint8_t frames = mySettings->generalSettings.transitionFrames;
+    if (!previousEffect || previousEffect == effect || mode == TransitionNone || frames < 2) {
+        return false;
+    }
+
+    transitioning = true;
+    outgoingEffect = previousEffect;
+    outgoingIndex = previousIndex;
+    outgoingActive = true;
+    // its settings can't change any more, the record takes over now
+    saveInstance(outgoingEffect, effects[outgoingIndex]);
+    transitionFrame = 0;
+    transitionFrames = frames;
+
+    const size_t bufferSize = myMatrix->getNumLeds() * sizeof(CRGB);
+    crossfade = maxAllocatableHeap() >= 2 * bufferSize + transitionHeapReserve;
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Transition: %s over %u frames\n"),
+        crossfade ? PSTR("crossfade") : PSTR("fade through black"), frames);
+#endif
+    if (!crossfade) {
+        // incoming effect is activated at the black midpoint, after the
+        // outgoing one freed its buffers
+        effectActive = false;
+        return true;
+    }
+
+    // outgoing effect keeps drawing on top of its last frame
+    outgoingBuffer = new CRGB[myMatrix->getNumLeds()];
+    memcpy(outgoingBuffer, myMatrix->getLeds(), bufferSize);
+    incomingBuffer = new CRGB[myMatrix->getNumLeds()]();
+
+    outgoingRotation = myMatrix->getRotation();
+    myMatrix->setDrawBuffer(incomingBuffer);
+    effect->start();
+    myMatrix->setDrawBuffer(nullptr);
+    incomingRotation = myMatrix->getRotation();
+    effectActive = true;
+    return true;
+}
+
+void EffectsManager::processTransition(uint32_t dt)
+{
+    Effect* effect = activeEffect();
+    ++transitionFrame;
+
+    if (crossfade) {
+        renderInto(outgoingBuffer, outgoingEffect, outgoingRotation, dt);
+        renderInto(incomingBuffer, effect, incomingRotation, dt);
+
+        const uint8_t amount = transitionFrame * 255 / transitionFrames;
+        blendFrames(myMatrix->getLeds(), amount,
+            mySettings->generalSettings.transitionMode == TransitionGamma);
+        myMatrix->setBrightness(lerp8by8(outgoingEffect->settings.brightness, effect->settings.brightness, amount));
+    }
+    else {
+        const uint8_t half = transitionFrames / 2;
+        if (transitionFrame <= half) {
+            // last outgoing frame stays in place and is dimmed at output
+            const uint8_t level = 255 - transitionFrame * 255 / half;
+            myMatrix->setBrightness(scale8(outgoingEffect->settings.brightness, level));
+            if (transitionFrame == half) {
+                myMatrix->show();
+                RenderLock lock;
+                outgoingEffect->stop();
+                outgoingActive = false;
+                myMatrix->clear();
+                effect->start();
+                effectActive = true;
+                return;
+            }
+        }
+        else {
+            effect->tick(dt);
+            const uint8_t level = (transitionFrame - half) * 255 / (transitionFrames - half);
+            myMatrix->setBrightness(scale8(effect->settings.brightness, level));
+        }
+    }
+
+    myMatrix->show();
+
+    if (transitionFrame >= transitionFrames) {
+        finishTransition();
+    }
+}
+
+void EffectsManager::finishTransition()
+{
+    if (!transitioning) {
+        return;
+    }
+
+    RenderLock lock;
+    if (outgoingActive) {
+        outgoingEffect->stop();
+        outgoingActive = false;
+    }
+
+    if (crossfade) {
+        // incoming effect continues from its own frame
+        memcpy(myMatrix->getLeds(), incomingBuffer, myMatrix->getNumLeds() * sizeof(CRGB));
+        delete[] outgoingBuffer;
+        delete[] incomingBuffer;
+        outgoingBuffer = nullptr;
+        incomingBuffer = nullptr;
+        if (myMatrix->getRotation() != incomingRotation) {
+            myMatrix->setRotation(incomingRotation);
+        }
+    }
+
+    myMatrix->setBrightness(activeEffect()->settings.brightness);
+    delete outgoingEffect;
+    outgoingEffect = nullptr;
+    transitioning = false;
+}
+
+#ifdef USE_PROFILER
+bool EffectsManager::renderOffscreen(uint8_t index, CRGB* buffer, uint16_t frames,
+                                     uint32_t seed, uint32_t* frameHashes, uint32_t* frameTime)
+{
+    FrameLock frameLock;
+    RenderLock lock;
+    // most effects keep their state at file scope, a second instance of
+    // the one on the lamp would draw into it and free its buffers
+    if ((index == activeIndex && effectActive) || (outgoingEffect && index == outgoingIndex && outgoingActive)) {
+        return false;
+    }
+    // a fresh instance, its settings don't go back into the list
+    Effect* effect = createInstance(effects[index]);
+    const uint8_t rotation = myMatrix->getRotation();
+
+    if (seed != 0) {
+        randomSeed(seed);
+        random16_set_seed(seed);
+    }
+
+    myMatrix->setDrawBuffer(buffer);
+    // effects see time pass by exactly one frame interval per tick
+    EffectClock::hold();
+    effect->start();
+    const uint32_t dt = effect->frameInterval();
+    uint32_t elapsed = 0;
+    for (uint16_t frame = 0; frame < frames; ++frame) {
+        EffectClock::advance(dt);
+        const uint32_t start = micros();
+        effect->tick(dt);
+        elapsed += micros() - start;
+        if (frameHashes) {
+            frameHashes[frame] = MyMatrix::hashFrame(buffer);
         }
+    }
+    effect->stop();
+    delete effect;
+    EffectClock::release();
+    if (seed != 0) {
+        randomSeed(micros());
+        random16_add_entropy(micros());
+    }
+    myMatrix->setDrawBuffer(nullptr);
+    if (myMatrix->getRotation() != rotation) {
+        myMatrix->setRotation(rotation);
+    }
+
+    if (frameTime) {
+        *frameTime = frames > 0 ? uint64_t(elapsed) * 1000 / frames : 0;
+    }
+    return true;
+}
+
+void EffectsManager::printFrameHashes(Print& out, uint16_t frames, uint32_t seed)
+{
+    CRGB* buffer = new CRGB[myMatrix->getNumLeds()];
+    uint32_t* hashes = new uint32_t[frames];
+
+    out.print('{');
+    bool first = true;
+    for (uint8_t index = 0; index < effects.size(); ++index) {
+        fill_solid(buffer, myMatrix->getNumLeds(), CRGB::Black);
+        const bool rendered = renderOffscreen(index, buffer, frames, seed, hashes);
+        // all effects in one go can outlast the watchdog of the calling task
+#if defined(ESP32)
+        esp_task_wdt_reset();
+#else
+        ESP.wdtFeed();
+#endif
+        if (!rendered) {
+            continue;
+        }
+
+        if (!first) {
+            out.print(',');
+        }
+        first = false;
+        out.print('"');
+        out.print(effectSettings(index).id);
+        out.print(F("\":["));
+        for (uint16_t frame = 0; frame < frames; ++frame) {
+            if (frame > 0) {
+                out.print(',');
+            }
+            out.print(hashes[frame]);
+        }
+        out.print(']');
+    }
+    out.print('}');
+
+    delete[] hashes;
+    delete[] buffer;
+}
+
+void EffectsManager::resetProfiles()
+{
+    FrameLock lock;
+    for (EffectRecord& record : effects) {
+        record.stats.profile.reset();
+    }
+}
+#endif
+
+#if defined(ESP32)
+void EffectsManager::startRenderTask(void (*render)())
+{
+    if (renderTaskHandle) {
         return;
     }
-    effectTimer = millis();
 
-    activeEffect()->Process();
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Starting render task on core %d\n"), renderTaskCore);
+#endif
+    renderCallback = render;
+    commands = xQueueCreate(commandsLength, sizeof(Command));
+    xTaskCreatePinnedToCore(renderTask,
+        "render",
+        renderTaskStackSize,
+        nullptr,
+        renderTaskPriority,
+        &renderTaskHandle,
+        renderTaskCore);
+}
+
+void EffectsManager::processCommands()
+{
+    Command command;
+    while (xQueueReceive(commands, &command, 0) == pdTRUE) {
+        switch (command.type) {
+        case CommandActivate:
+            activateEffect(command.index, command.save);
+            break;
+        case CommandNext:
+            next();
+            break;
+        case CommandPrevious:
+            previous();
+            break;
+        case CommandUpdate:
+        case CommandUpdateActive: {
+            DynamicJsonDocument doc(commandJsonSize);
+            deserializeJson(doc, *command.json);
+            updateSettings(command.type == CommandUpdateActive ? activeIndex : command.index,
+                doc.as<JsonObject>());
+            break;
+        }
+        case CommandBrightness:
+            setActiveBrightness(command.index);
+            break;
+        }
+        delete command.json;
+    }
 }
 
+void EffectsManager::processNotifications()
+{
+    if (!notifyPending.exchange(false)) {
+        return;
+    }
+    notifyChanged(savePending.exchange(false));
+}
+#endif
+
 void EffectsManager::next()
 {
-    myMatrix->clear();
+#if defined(ESP32)
+    if (queueCommand(CommandNext)) {
+        return;
+    }
+#endif
     uint8_t aIndex = activeIndex;
     if (aIndex == effects.size() - 1) {
         aIndex = 0;
@@ -160,7 +772,11 @@ void EffectsManager::next()
 
 void EffectsManager::previous()
 {
-    myMatrix->clear();
+#if defined(ESP32)
+    if (queueCommand(CommandPrevious)) {
+        return;
+    }
+#endif
     uint8_t aIndex = activeIndex;
     if (aIndex == 0) {
         aIndex = static_cast<uint8_t>(effects.size() - 1);
@@ -173,75 +789,118 @@ void EffectsManager::previous()
 
 void EffectsManager::changeEffectByName(const String& name)
 {
-    for (size_t index = 0; index < effects.size(); index++) {
-        Effect* effect = effects[index];
-        if (effect->settings.name == name) {
-            activateEffect(index);
-            break;
-        }
+    const int16_t index = lookupEffect(name, true);
+    if (index >= 0) {
+        activateEffect(index);
     }
 }
 
 void EffectsManager::changeEffectById(const String& id)
 {
-    for (size_t index = 0; index < effects.size(); index++) {
-        Effect* effect = effects[index];
-        if (effect->settings.id == id) {
-            activateEffect(index);
-            break;
-        }
+    const int16_t index = lookupEffect(id, false);
+    if (index >= 0) {
+        activateEffect(index);
     }
 }
 
 void EffectsManager::activateEffect(uint8_t index, bool save)
 {
+#if defined(ESP32)
+    if (queueCommand(CommandActivate, index, save)) {
+        return;
+    }
+#endif
+    RenderLock lock;
     if (index >= effects.size()) {
         index = 0;
     }
-    myMatrix->clear();
-    activeEffect()->deactivate();
-    if (activeIndex != index) {
+    finishTransition();
+    Effect* previousInstance = activeInstance;
+    const uint8_t previousIndex = activeIndex;
+    Effect* previousEffect = effectActive ? previousInstance : nullptr;
+    Effect* effect = previousInstance;
+    if (!effect || activeIndex != index) {
+        effect = createInstance(effects[index]);
+        activeInstance = effect;
         activeIndex = index;
+        // effect specific defaults show up in the record
+        saveInstance(effect, effects[index]);
     }
-    Effect* effect = effects[index];
-    myMatrix->setBrightness(effect->settings.brightness);
+    scheduler.reset(millis());
 #ifdef USE_DEBUG
     Serial.printf_P(PSTR("Activating effect[%u]: %s\n"), index, effect->settings.name.c_str());
 #endif
-    effect->activate();
-    if (mqtt) {
-        mqtt->update();
+    if (!beginTransition(previousEffect, previousIndex, effect)) {
+        myMatrix->clear();
+        if (previousEffect) {
+            previousEffect->stop();
+        }
+        myMatrix->setBrightness(effect->settings.brightness);
+        effect->start();
+        effectActive = true;
     }
-    lampWebServer->update();
-    if (!save) {
-        return;
+    // a transition releases the outgoing instance when it is done
+    if (previousInstance && previousInstance != effect && previousInstance != outgoingEffect) {
+        releaseInstance(previousInstance, effects[previousIndex]);
     }
-    mySettings->saveLater();
+    notifyChanged(save);
 }
 
 void EffectsManager::updateCurrentSettings(const JsonObject& json)
 {
-    activeEffect()->initialize(json);
-    myMatrix->setBrightness(activeEffect()->settings.brightness);
-    mySettings->saveLater();
+#if defined(ESP32)
+    if (queueCommand(CommandUpdateActive, 0, false, &json)) {
+        return;
+    }
+#endif
+    updateSettings(activeIndex, json);
 }
 
 void EffectsManager::updateSettingsById(const String& id, const JsonObject& json)
 {
-    for (size_t index = 0; index < effects.size(); index++) {
-        Effect* effect = effects[index];
-        if (effect->settings.id == id) {
-            if (effect != effects[activeIndex]) {
-                activateEffect(index);
-            }
-            effect->initialize(json);
-            break;
-        }
+    const int16_t index = lookupEffect(id, false);
+    if (index < 0) {
+        return;
+    }
+#if defined(ESP32)
+    if (queueCommand(CommandUpdate, index, false, &json)) {
+        return;
+    }
+#endif
+    updateSettings(index, json);
+}
+
+void EffectsManager::updateSettings(uint8_t index, const JsonObject& json)
+{
+    RenderLock lock;
+    if (renames(effects[index].settings, json)) {
+        lookupValid = false;
+    }
+    if (index == activeIndex && activeInstance) {
+        activeInstance->initialize(json);
+        saveInstance(activeInstance, effects[index]);
+    }
+    else {
+        applySettings(effects[index], json);
+        activateEffect(index);
     }
     myMatrix->setBrightness(activeEffect()->settings.brightness);
+#if defined(ESP32)
+    if (renderTaskHandle) {
+        // callers announced the settings before the render task got to them
+        notifyChanged(true);
+        return;
+    }
+#endif
     mySettings->saveLater();
 }
 
+int16_t EffectsManager::lookupEffect(const String& key, bool byName)
+{
+    RenderLock lock;
+    return findEffect(key, byName);
+}
+
 uint8_t EffectsManager::count()
 {
     return static_cast<uint8_t>(effects.size());
@@ -249,11 +908,46 @@ uint8_t EffectsManager::count()
 
 Effect* EffectsManager::activeEffect()
 {
-    if (effects.size() > activeIndex) {
-        return effects[activeIndex];
+    if (!activeInstance && effects.size() > activeIndex) {
+        RenderLock lock;
+        activeInstance = createInstance(effects[activeIndex]);
+        saveInstance(activeInstance, effects[activeIndex]);
     }
 
-    return nullptr;
+    return activeInstance;
+}
+
+Settings::EffectSettings EffectsManager::effectSettings(uint8_t index)
+{
+    RenderLock lock;
+    return effects[index].settings;
+}
+
+void EffectsManager::writeEffectSettings(uint8_t index, JsonObject& json)
+{
+    const String extra = effectExtra(index);
+    if (extra.length() == 0) {
+        return;
+    }
+    DynamicJsonDocument doc(extraJsonSize);
+    deserializeJson(doc, extra);
+    for (JsonPair pair : doc.as<JsonObject>()) {
+        // String key makes json keep its own copy
+        json[String(pair.key().c_str())] = pair.value();
+    }
+}
+
+String EffectsManager::effectExtra(uint8_t index)
+{
+    RenderLock lock;
+    return effects[index].extra;
+}
+
+EffectStats EffectsManager::effectStats(uint8_t index)
+{
+    // instances update the stats while they draw
+    FrameLock lock;
+    return effects[index].stats;
 }
 
 uint8_t EffectsManager::activeEffectIndex()
@@ -261,74 +955,44 @@ uint8_t EffectsManager::activeEffectIndex()
     return activeIndex;
 }
 
-template <typename T>
-void RegisterEffect(const String& id)
+uint8_t EffectsManager::activeBrightness()
 {
-    effectsMap[id] = new T(id);
+    RenderLock lock;
+    return effects[activeIndex].settings.brightness;
+}
+
+void EffectsManager::setActiveBrightness(uint8_t brightness)
+{
+#if defined(ESP32)
+    if (queueCommand(CommandBrightness, brightness)) {
+        return;
+    }
+#endif
+    RenderLock lock;
+    activeEffect()->settings.brightness = brightness;
+    effects[activeIndex].settings.brightness = brightness;
+    myMatrix->setBrightness(brightness);
+}
+
+uint32_t EffectsManager::droppedCommands()
+{
+#if defined(ESP32)
+    return dropped;
+#else
+    return 0;
+#endif
+}
+
+const FrameScheduler& EffectsManager::frameScheduler()
+{
+    return scheduler;
 }
 
 EffectsManager::EffectsManager()
 {
+#if defined(ESP32)
+    renderMutex = xSemaphoreCreateRecursiveMutex();
+    frameMutex = xSemaphoreCreateMutex();
+#endif
     randomSeed(micros());
-
-    RegisterEffect<SparklesEffect>(F("Sparkles"));
-    RegisterEffect<FireEffect>(F("Fire"));
-    RegisterEffect<VerticalRainbowEffect>(F("VerticalRainbow"));
-    RegisterEffect<HorizontalRainbowEffect>(F("HorizontalRainbow"));
-    RegisterEffect<ColorsEffect>(F("Colors"));
-    // RegisterEffect<MadnessNoiseEffect>(F("MadnessNoise"));
-    // RegisterEffect<CloudNoiseEffect>(F("CloudNoise"));
-    // RegisterEffect<LavaNoiseEffect>(F("LavaNoise"));
-    // RegisterEffect<PlasmaNoiseEffect>(F("PlasmaNoise"));
-    // RegisterEffect<RainbowNoiseEffect>(F("RainbowNoise"));
-    // RegisterEffect<RainbowStripeNoiseEffect>(F("RainbowStripeNoise"));
-    // RegisterEffect<ZebraNoiseEffect>(F("ZebraNoise"));
-    // RegisterEffect<ForestNoiseEffect>(F("ForestNoise"));
-    // RegisterEffect<OceanNoiseEffect>(F("OceanNoise"));
-    RegisterEffect<ColorEffect>(F("Color"));
-    RegisterEffect<SnowEffect>(F("Snow"));
-    RegisterEffect<MatrixEffect>(F("Matrix"));
-    RegisterEffect<LightersEffect>(F("Lighters"));
-    // RegisterEffect<ClockEffect>(F("Clock"));
-    // RegisterEffect<ClockHorizontal1Effect>(F("ClockHorizontal1"));
-    // RegisterEffect<ClockHorizontal2Effect>(F("ClockHorizontal2"));
-    // RegisterEffect<ClockHorizontal3Effect>(F("ClockHorizontal3"));
-    RegisterEffect<StarfallEffect>(F("Starfall"));
-    RegisterEffect<DiagonalRainbowEffect>(F("DiagonalRainbow"));
-    RegisterEffect<WaterfallEffect>(F("Waterfall"));
-    RegisterEffect<TwirlRainbowEffect>(F("TwirlRainbow"));
-    RegisterEffect<PulseCirclesEffect>(F("PulseCircles"));
-    // RegisterEffect<AnimationEffect>(F("Animation"));
-    RegisterEffect<StormEffect>(F("Storm"));
-    RegisterEffect<Matrix2Effect>(F("Matrix2"));
-    RegisterEffect<TrackingLightersEffect>(F("TrackingLighters"));
-    RegisterEffect<LightBallsEffect>(F("LightBalls"));
-    RegisterEffect<MovingCubeEffect>(F("MovingCube"));
-    RegisterEffect<WhiteColorEffect>(F("WhiteColor"));
-    RegisterEffect<PulsingCometEffect>(F("PulsingComet"));
-    RegisterEffect<DoubleCometsEffect>(F("DoubleComets"));
-    RegisterEffect<TripleCometsEffect>(F("TripleComets"));
-    RegisterEffect<RainbowCometEffect>(F("RainbowComet"));
-    RegisterEffect<ColorCometEffect>(F("ColorComet"));
-    RegisterEffect<MovingFlameEffect>(F("MovingFlame"));
-    RegisterEffect<FractorialFireEffect>(F("FractorialFire"));
-    RegisterEffect<RainbowKiteEffect>(F("RainbowKite"));
-    RegisterEffect<BouncingBallsEffect>(F("BouncingBalls"));
-    RegisterEffect<SpiralEffect>(F("Spiral"));
-    RegisterEffect<MetaBallsEffect>(F("MetaBalls"));
-    RegisterEffect<SinusoidEffect>(F("Sinusoid"));
-    RegisterEffect<WaterfallPaletteEffect>(F("WaterfallPalette"));
-    RegisterEffect<RainEffect>(F("Rain"));
-    RegisterEffect<PrismataEffect>(F("Prismata"));
-    RegisterEffect<FlockEffect>(F("Flock"));
-    RegisterEffect<WhirlEffect>(F("Whirl"));
-    RegisterEffect<WaveEffect>(F("Wave"));
-    // RegisterEffect<Fire12Effect>(F("Fire12"));
-    // RegisterEffect<Fire18Effect>(F("Fire18"));
-    // RegisterEffect<RainNeoEffect>(F("RainNeo"));
-    // RegisterEffect<TwinklesEffect>(F("Twinkles"));
-    //    RegisterEffect<SoundEffect>(F("Sound"));
-    //    RegisterEffect<SoundStereoEffect>(F("Stereo"));
-    // RegisterEffect<DMXEffect>(F("DMX"));
-    // RegisterEffect<ScrollingTextEffect>(F("Text"));
 }
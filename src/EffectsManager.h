@@ -2,10 +2,23 @@
 #include <Arduino.h>
 #define ARDUINOJSON_ENABLE_PROGMEM 1
 #include <ArduinoJson.h>
+#include "FrameScheduler.h"
+#include "effects/Effect.h"
 
 #define effectsManager EffectsManager::instance()
 
-class Effect;
+// Effect in the list as it is kept while not running: its entry in the
+// flash factory table and its settings. Only the active effect (two of
+// them during a crossfade) is instantiated.
+struct EffectRecord
+{
+    uint8_t factory = 0;
+    Settings::EffectSettings settings;
+    // json written by writeSettings() of the last instance, empty if none
+    String extra;
+    EffectStats stats;
+};
+
 class EffectsManager
 {
 public:
@@ -13,8 +26,18 @@ public:
     static void Initialize();
 
     void loop();
+#if defined(ESP32)
+    void startRenderTask(void (*render)());
+    // Render task: effect switches queued by other tasks
+    void processCommands();
+    // Service task: mqtt, web server and settings updates for effect
+    // switches done by the render task
+    void processNotifications();
+#endif
 
     void processEffectSettings(const JsonObject &json);
+    // Adds an effect with settings already parsed, extra as in EffectRecord
+    void addEffect(const Settings::EffectSettings &settings, const String &extra);
     void processAllEffects();
 
     void next();
@@ -23,17 +46,65 @@ public:
     void changeEffectById(const String &id);
     void activateEffect(uint8_t index, bool save = true);
 
+    // On ESP32 applied by the render task, which announces them to mqtt and
+    // the web server again once they are in the records
     void updateCurrentSettings(const JsonObject &json);
     void updateSettingsById(const String &id, const JsonObject &json);
 
     uint8_t count();
 
-    Effect *activeEffect();
     uint8_t activeEffectIndex();
+    // Brightness of the running effect, setting it applies it right away
+    // (on ESP32 with the next frame)
+    uint8_t activeBrightness();
+    void setActiveBrightness(uint8_t brightness);
+    // Commands the render task could not take within the queue timeout
+    uint32_t droppedCommands();
+
+    // Settings of the effect at index as the render task published them
+    // last. A copy, the record may change as soon as the lock is released.
+    Settings::EffectSettings effectSettings(uint8_t index);
+    // Effect specific settings of the effect at index
+    void writeEffectSettings(uint8_t index, JsonObject &json);
+    // Effect specific settings of the effect at index serialized to json
+    String effectExtra(uint8_t index);
+    // Statistics of the effect at index, copied between frames
+    EffectStats effectStats(uint8_t index);
+
+    const FrameScheduler &frameScheduler();
 
-    std::vector<Effect*> effects = {};
+#ifdef USE_PROFILER
+    // Renders frames of a fresh instance of effect into buffer without
+    // touching the lamp output. The effect on the lamp is refused, false is
+    // returned. A non-zero seed makes random numbers repeatable,
+    // frameHashes receives hashFrame() of every frame and frameTime the
+    // average tick time in nanoseconds.
+    bool renderOffscreen(uint8_t index, CRGB *buffer, uint16_t frames, uint32_t seed = 0,
+                         uint32_t *frameHashes = nullptr, uint32_t *frameTime = nullptr);
+    // Json object of effect id -> array of frame hashes for every effect in
+    // the list rendered from a fresh start with the given seed, except the
+    // one on the lamp
+    void printFrameHashes(Print &out, uint16_t frames, uint32_t seed);
+    // Clears the tick and show timings of every effect between frames
+    void resetProfiles();
+#endif
+
+    // Filled once while reading settings, instances keep pointers to stats
+    std::vector<EffectRecord> effects = {};
 
 protected:
     EffectsManager();
+
+    // The running instance, only for the render task or under its lock
+    Effect *activeEffect();
+
+    // Applies settings json to the effect at index, in the render task
+    void updateSettings(uint8_t index, const JsonObject &json);
+    // Index of the effect with that id or name, -1 if none
+    int16_t lookupEffect(const String &key, bool byName);
+
+    bool beginTransition(Effect *previousEffect, uint8_t previousIndex, Effect *effect);
+    void processTransition(uint32_t dt);
+    void finishTransition();
 };
 
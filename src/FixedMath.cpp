@@ -0,0 +1,26 @@
+#include "FixedMath.h"
+
+namespace FixedMath {
+
+uint16_t isqrt32(uint32_t value)
+{
+    // digit-by-digit method, two result bits per iteration, no multiplications
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint16_t>(result);
+}
+
+} // namespace FixedMath
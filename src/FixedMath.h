@@ -0,0 +1,69 @@
+#pragma once
+#include <FastLED.h>
+
+// Fixed-point helpers for per-pixel effect math. ESP8266 has no FPU, so
+// every float operation there is a library call.
+// q8_8 keeps values in 1/256 steps, q16_16 in 1/65536 steps.
+typedef int16_t q8_8;
+typedef int32_t q16_16;
+
+namespace FixedMath {
+
+constexpr q8_8 toQ8_8(float value)
+{
+    return static_cast<q8_8>(value * 256.0f + (value < 0 ? -0.5f : 0.5f));
+}
+
+constexpr q16_16 toQ16_16(float value)
+{
+    return static_cast<q16_16>(value * 65536.0f + (value < 0 ? -0.5f : 0.5f));
+}
+
+// Integer square root, floor(sqrt(value))
+uint16_t isqrt32(uint32_t value);
+
+// sqrt of a non-negative q16_16 value, result is q8_8
+inline uint16_t sqrtQ16_16(uint32_t value)
+{
+    return isqrt32(value);
+}
+
+// sqrt(x * x + y * y) for q8_8 arguments, result is q8_8
+inline uint16_t hypotQ8_8(q8_8 x, q8_8 y)
+{
+    return isqrt32(uint32_t(int32_t(x) * x) + uint32_t(int32_t(y) * y));
+}
+
+// Angle in radians (q8_8, any sign) to FastLED angle units where 65536 is a full turn
+inline uint16_t angleFromRadians(int32_t radians)
+{
+    // 65536 / (2 * pi) = 10430.38
+    return static_cast<uint16_t>((radians * 10430) >> 8);
+}
+
+// Sine and cosine of a FastLED angle, result is q1.15 in [-32767, 32767].
+// Backed by FastLED's table-driven sin16 which stays within 0.7% of sinf.
+inline int16_t sinQ15(uint16_t angle)
+{
+    return sin16(angle);
+}
+
+inline int16_t cosQ15(uint16_t angle)
+{
+    return cos16(angle);
+}
+
+// Sine of radians given as q8_8, result is q1.15. Within 0.75% of sinf,
+// the angle conversion adds a little to the error of sin16
+inline int16_t sinRadians(int32_t radians)
+{
+    return sin16(angleFromRadians(radians));
+}
+
+// a * b for q1.15 factor b and |a| < 65536, keeps the format of a
+inline int32_t mulQ15(int32_t a, int16_t b)
+{
+    return (a * b) >> 15;
+}
+
+} // namespace FixedMath
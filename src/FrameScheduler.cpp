@@ -0,0 +1,93 @@
+#include "FrameScheduler.h"
+
+void FrameScheduler::reset(uint32_t now)
+{
+    nextDeadline = now;
+    lastFrame = now;
+    started = false;
+}
+
+void FrameScheduler::setInterval(uint32_t intervalMs)
+{
+    if (intervalMs == frameInterval) {
+        return;
+    }
+    // keep the pending deadline relative to the last frame
+    nextDeadline = lastFrame + intervalMs;
+    frameInterval = intervalMs;
+}
+
+void FrameScheduler::setPolicy(Policy newPolicy)
+{
+    policy = newPolicy;
+}
+
+uint8_t FrameScheduler::framesDue(uint32_t now)
+{
+    if (!started) {
+        started = true;
+        nextDeadline = now + frameInterval;
+        lastFrame = now - frameInterval;
+        ++frameCounter;
+        return 1;
+    }
+
+    if (static_cast<int32_t>(now - nextDeadline) < 0) {
+        return 0;
+    }
+
+    if (frameInterval == 0) {
+        nextDeadline = now;
+        ++frameCounter;
+        return 1;
+    }
+
+    // whole frame slots that passed without a frame
+    const uint32_t missed = (now - nextDeadline) / frameInterval;
+    nextDeadline += frameInterval * (missed + 1);
+
+    uint8_t frames = 1;
+    if (missed > 0) {
+        ++missCounter;
+        if (policy == PolicyCatchUp) {
+            frames = missed + 1 < maxCatchUpFrames ? static_cast<uint8_t>(missed + 1) : maxCatchUpFrames;
+        }
+        skipCounter += missed + 1 - frames;
+    }
+    frameCounter += frames;
+    return frames;
+}
+
+uint32_t FrameScheduler::elapsed(uint32_t now)
+{
+    const uint32_t dt = now - lastFrame;
+    lastFrame = now;
+    return dt;
+}
+
+uint32_t FrameScheduler::interval() const
+{
+    return frameInterval;
+}
+
+uint32_t FrameScheduler::frames() const
+{
+    return frameCounter;
+}
+
+uint32_t FrameScheduler::deadlineMisses() const
+{
+    return missCounter;
+}
+
+uint32_t FrameScheduler::skippedFrames() const
+{
+    return skipCounter;
+}
+
+void FrameScheduler::resetCounters()
+{
+    frameCounter = 0;
+    missCounter = 0;
+    skipCounter = 0;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <Arduino.h>
+
+// Keeps effect frames on a fixed time grid, so frame timing does not drift
+// by however long tick() and show() took
+class FrameScheduler
+{
+public:
+    enum Policy : uint8_t {
+        // drop frames that were missed, render once and resync to the grid
+        PolicySkip = 0,
+        // render missed frames back to back (up to maxCatchUpFrames)
+        PolicyCatchUp = 1
+    };
+
+    static const uint8_t maxCatchUpFrames = 4;
+
+    void reset(uint32_t now);
+    void setInterval(uint32_t intervalMs);
+    void setPolicy(Policy policy);
+
+    // Number of frames to render now, 0 if next frame is not due yet
+    uint8_t framesDue(uint32_t now);
+    // Milliseconds since previous rendered frame, updates the reference point
+    uint32_t elapsed(uint32_t now);
+
+    uint32_t interval() const;
+    uint32_t frames() const;
+    uint32_t deadlineMisses() const;
+    uint32_t skippedFrames() const;
+    void resetCounters();
+
+private:
+    Policy policy = PolicySkip;
+    uint32_t frameInterval = 0;
+    uint32_t nextDeadline = 0;
+    uint32_t lastFrame = 0;
+    bool started = false;
+
+    uint32_t frameCounter = 0;
+    uint32_t missCounter = 0;
+    uint32_t skipCounter = 0;
+};
@@ -2,6 +2,8 @@
 #include "LampWebServer.h"
 #include "MyMatrix.h"
 #include "Settings.h"
+#include "SettingsSnapshot.h"
+#include "SettingsWriter.h"
 #include "effects/Effect.h"
 
 #if defined(ESP32)
@@ -29,6 +31,7 @@ extern "C" uint32_t _FS_end;
 #include <AsyncJson.h>
 #include <ArduinoJson.h>
 #include <Ticker.h>
+#include <new>
 
 
 namespace {
@@ -52,6 +55,18 @@ namespace {
 
     Ticker updateTimer;
 
+    // Sees every request before the real handlers, only to hold back
+    // dither refreshes while the server is busy
+    class NetworkActivityHandler : public AsyncWebHandler
+    {
+    public:
+        bool canHandle(AsyncWebServerRequest* request) override
+        {
+            MyMatrix::noteNetworkActivity();
+            return false;
+        }
+    };
+
     void staticUpdate()
     {
         if (!lampWebServer) {
@@ -125,6 +140,7 @@ namespace {
 #endif
         }
         else if (type == WS_EVT_DATA) {
+            MyMatrix::noteNetworkActivity();
             AwsFrameInfo* info = reinterpret_cast<AwsFrameInfo*>(arg);
             String msg = "";
             if (info->final && info->index == 0 && info->len == len) {
@@ -290,6 +306,10 @@ namespace {
             Serial.printf_P(PSTR("Total size: %zu\n"), total);
 #endif
             myMatrix->clear();
+            if (data[0] == '{' || data[0] == '[') {
+                // the uploaded json is read at next boot instead of the snapshot
+                SettingsSnapshot::discard();
+            }
             if (data[0] == '{') {
                 if (json) {
                     json.close();
@@ -513,14 +533,39 @@ LampWebServer::LampWebServer(uint16_t webPort)
     socket = new AsyncWebSocket(F("/ws"));
     socket->onEvent(onWsEvent);
 
+    webServer->addHandler(new NetworkActivityHandler());
     webServer->addHandler(socket);
 
     webServer->rewrite(PSTR("/"), PSTR("/index-cdn.html")).setFilter(ON_STA_FILTER);
     webServer->rewrite(PSTR("/"), PSTR("/index.html")).setFilter(ON_AP_FILTER);
     webServer->serveStatic(PSTR("/static/js/"), FLASHFS, PSTR("/"), PSTR("max-age=86400"));
     webServer->serveStatic(PSTR("/static/css/"), FLASHFS, PSTR("/"), PSTR("max-age=86400"));
-    webServer->serveStatic(PSTR("/effects.json"), FLASHFS, PSTR("/effects.json"), PSTR("no-cache"));
-    webServer->serveStatic(PSTR("/settings.json"), FLASHFS, PSTR("/settings.json"), PSTR("no-cache"));
+    // built from memory, the files on flash lag behind until the settings
+    // journal is compacted
+    webServer->on(PSTR("/effects.json"), HTTP_GET, [](AsyncWebServerRequest* request) {
+        AsyncResponseStream* response = request->beginResponseStream(F("application/json"));
+        response->addHeader(F("Cache-Control"), F("no-cache"));
+        response->print('[');
+        for (uint8_t index = 0; index < effectsManager->count(); ++index) {
+            if (index > 0) {
+                response->print(',');
+            }
+            DynamicJsonDocument json(768);
+            JsonObject effect = json.to<JsonObject>();
+            mySettings->buildEffectJson(index, effect);
+            serializeJson(json, *response);
+        }
+        response->print(']');
+        request->send(response);
+        });
+    webServer->on(PSTR("/settings.json"), HTTP_GET, [](AsyncWebServerRequest* request) {
+        AsyncJsonResponse* response = new AsyncJsonResponse(false, 512 * 3);
+        response->addHeader(F("Cache-Control"), F("no-cache"));
+        JsonObject root = response->getRoot();
+        mySettings->buildSettingsJson(root);
+        response->setLength();
+        request->send(response);
+        });
     webServer->serveStatic(PSTR("/"), FLASHFS, PSTR("/"), PSTR("max-age=86400"));
 
     webServer->on(PSTR("/effectJson"), HTTP_GET, [](AsyncWebServerRequest* request) {
@@ -531,6 +576,148 @@ LampWebServer::LampWebServer(uint16_t webPort)
         request->send(response);
         });
 
+    webServer->on(PSTR("/stats/output"), HTTP_GET, [](AsyncWebServerRequest* request) {
+        AsyncResponseStream* response = request->beginResponseStream(F("application/json"));
+        response->printf_P(PSTR("{\"frames\":%u,\"ditherRefreshes\":%u,\"ditherBackoffs\":%u,"
+            "\"milliamps\":%u,\"currentLimit\":%u,\"droppedCommands\":%u}"),
+            MyMatrix::shownFrames(), MyMatrix::ditherRefreshes(), MyMatrix::ditherBackoffs(),
+            MyMatrix::frameMilliamps(), mySettings->matrixSettings.currentLimit,
+            effectsManager->droppedCommands());
+        request->send(response);
+        });
+
+    webServer->on(PSTR("/stats/settings"), HTTP_GET, [](AsyncWebServerRequest* request) {
+        AsyncResponseStream* response = request->beginResponseStream(F("application/json"));
+        response->printf_P(PSTR("{\"saveMicros\":%u,\"chunkMicros\":%u,\"fileMillis\":%u,"
+            "\"files\":%u,\"idle\":%s}"),
+            mySettings->maxSaveMicros(), SettingsWriter::maxChunkMicros(), SettingsWriter::maxFileMillis(),
+            SettingsWriter::filesWritten(), SettingsWriter::idle() ? PSTR("true") : PSTR("false"));
+        request->send(response);
+        });
+
+    webServer->on(PSTR("/stats/arena"), HTTP_GET, [](AsyncWebServerRequest* request) {
+        AsyncResponseStream* response = request->beginResponseStream(F("application/json"));
+        response->printf_P(PSTR("{\"slotSize\":%u,\"slots\":%u,\"effects\":["),
+            EffectArena::slotSize(), EffectArena::slotsCount);
+        bool first = true;
+        for (uint8_t index = 0; index < effectsManager->count(); ++index) {
+            const EffectStats stats = effectsManager->effectStats(index);
+            if (stats.arenaHighWater == 0) {
+                continue;
+            }
+            if (!first) {
+                response->print(',');
+            }
+            first = false;
+            response->print(F("{\"i\":\""));
+            response->print(effectsManager->effectSettings(index).id);
+            response->print(F("\",\"bytes\":"));
+            response->print(stats.arenaHighWater);
+            response->print('}');
+        }
+        response->print(F("]}"));
+        request->send(response);
+        });
+
+#ifdef USE_PROFILER
+    webServer->on(PSTR("/stats/effects"), HTTP_GET, [](AsyncWebServerRequest* request) {
+        AsyncResponseStream* response = request->beginResponseStream(F("application/json"));
+        response->print('[');
+        bool first = true;
+        for (uint8_t index = 0; index < effectsManager->count(); ++index) {
+            const EffectStats stats = effectsManager->effectStats(index);
+            if (stats.profile.tick.count == 0) {
+                continue;
+            }
+            if (!first) {
+                response->print(',');
+            }
+            first = false;
+            response->print(F("{\"i\":\""));
+            response->print(effectsManager->effectSettings(index).id);
+            response->print(F("\",\"tick\":"));
+            stats.profile.tick.printJson(*response);
+            response->print(F(",\"show\":"));
+            stats.profile.show.printJson(*response);
+            response->print('}');
+        }
+        response->print(']');
+        request->send(response);
+
+        if (request->hasArg(F("reset"))) {
+            effectsManager->resetProfiles();
+        }
+        });
+
+    webServer->on(PSTR("/render/hashes"), HTTP_GET, [](AsyncWebServerRequest* request) {
+        uint16_t frames = 8;
+        if (request->hasArg(F("frames"))) {
+            frames = constrain(request->arg(F("frames")).toInt(), 1, 64);
+        }
+        uint32_t seed = 1;
+        if (request->hasArg(F("seed"))) {
+            seed = request->arg(F("seed")).toInt();
+        }
+
+        AsyncResponseStream* response = request->beginResponseStream(F("application/json"));
+        effectsManager->printFrameHashes(*response, frames, seed);
+        request->send(response);
+        });
+
+    webServer->on(PSTR("/render"), HTTP_GET, [](AsyncWebServerRequest* request) {
+        const uint8_t count = effectsManager->count();
+        uint8_t index = count;
+        if (request->hasArg(F("i"))) {
+            const String id = request->arg(F("i"));
+            for (index = 0; index < count; ++index) {
+                if (effectsManager->effectSettings(index).id == id) {
+                    break;
+                }
+            }
+        }
+        if (index == count) {
+            request->send(404, F("text/plain"), F("Unknown effect"));
+            return;
+        }
+
+        uint16_t frames = 1;
+        if (request->hasArg(F("frames"))) {
+            frames = constrain(request->arg(F("frames")).toInt(), 1, 1000);
+        }
+        uint32_t seed = 0;
+        if (request->hasArg(F("seed"))) {
+            seed = request->arg(F("seed")).toInt();
+        }
+
+        CRGB* buffer = new (std::nothrow) CRGB[myMatrix->getNumLeds()]();
+        if (!buffer) {
+            request->send(503, F("text/plain"), F("Out of memory"));
+            return;
+        }
+        uint32_t frameTime = 0;
+        if (!effectsManager->renderOffscreen(index, buffer, frames, seed, nullptr, &frameTime)) {
+            delete[] buffer;
+            request->send(409, F("text/plain"), F("Effect is running"));
+            return;
+        }
+
+        // last frame as binary PPM in matrix coordinates
+        const uint8_t width = mySettings->matrixSettings.width;
+        const uint8_t height = mySettings->matrixSettings.height;
+        AsyncResponseStream* response = request->beginResponseStream(F("image/x-portable-pixmap"));
+        response->addHeader(F("X-Frame-Time-Ns"), String(frameTime));
+        response->printf_P(PSTR("P6\n%u %u\n255\n"), width, height);
+        for (uint8_t y = 0; y < height; ++y) {
+            for (uint8_t x = 0; x < width; ++x) {
+                const CRGB& pixel = buffer[myMatrix->XY(x, y)];
+                response->write(pixel.raw, 3);
+            }
+        }
+        delete[] buffer;
+        request->send(response);
+        });
+#endif
+
     webServer->on(PSTR("/reboot"), HTTP_GET, [](AsyncWebServerRequest* request) {
         if (mySettings->busy) {
             request->send(200, F("text/html"), F("Busy, try again later"));
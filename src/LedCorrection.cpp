@@ -0,0 +1,18 @@
+#include "LedCorrection.h"
+
+LedCorrection ledCorrection;
+
+LedCorrection::LedCorrection()
+{
+    build(1.0f, CRGB::White);
+}
+
+void LedCorrection::build(float gamma, const CRGB& white)
+{
+    for (uint8_t channel = 0; channel < 3; ++channel) {
+        for (uint16_t value = 0; value < 256; ++value) {
+            const float corrected = gamma == 1.0f ? value / 255.0f : powf(value / 255.0f, gamma);
+            table[channel][value] = static_cast<uint8_t>(corrected * white.raw[channel] + 0.5f);
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <FastLED.h>
+
+// Per channel gamma and white point lookup, indexed by RGB channel.
+// Applied by the led controllers to every byte on its way out, before
+// dithering and brightness scaling, so effects keep drawing linear colors.
+struct LedCorrection
+{
+    uint8_t table[3][256];
+
+    LedCorrection();
+    void build(float gamma, const CRGB& white);
+};
+
+extern LedCorrection ledCorrection;
+
+// Drop-in for PixelController::loadAndScale<SLOT> with the correction applied
+template <int SLOT, EOrder RGB_ORDER>
+__attribute__((always_inline)) inline uint8_t loadCorrectAndScale(PixelController<RGB_ORDER>& pixels)
+{
+    typedef PixelController<RGB_ORDER> Pixels;
+    const uint8_t value = ledCorrection.table[RGB_BYTE(RGB_ORDER, SLOT)][Pixels::template loadByte<SLOT>(pixels)];
+    return Pixels::template scale<SLOT>(pixels, Pixels::template dither<SLOT>(pixels, value));
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+
+// Counters kept by the led output drivers, used to compare them
+struct LedOutputStats
+{
+    // frames handed over to the driver
+    volatile uint32_t frames = 0;
+    // bit-bang output restarted because an interrupt broke the timing
+    volatile uint32_t retries = 0;
+    // frames given up or sent out corrupted
+    volatile uint32_t aborts = 0;
+};
+
+extern LedOutputStats ledOutputStats;
@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+
+// Split of the led array over several data pins into contiguous runs
+// whose lengths differ by at most one led.
+
+// First led of strip when count leds are split into strips runs,
+// strip == strips gives the end of the last one
+inline uint16_t stripStart(uint8_t strip, uint8_t strips, uint16_t count)
+{
+    return static_cast<uint32_t>(count) * strip / strips;
+}
+
+inline uint16_t stripLength(uint8_t strip, uint8_t strips, uint16_t count)
+{
+    return stripStart(strip + 1, strips, count) - stripStart(strip, strips, count);
+}
@@ -13,6 +13,7 @@
 #include <Ticker.h>
 #include <AsyncMqttClient.h>
 
+#include "MyMatrix.h"
 #include "Settings.h"
 
 namespace
@@ -166,6 +167,7 @@ namespace
 #ifdef USE_DEBUG
         Serial.println(topic);
 #endif
+        MyMatrix::noteNetworkActivity();
         char* buffer = new char[len + 1]();
         memcpy(buffer, payload, len);
         String message = buffer;
@@ -24,8 +24,20 @@ static xSemaphoreHandle gTX_sem = NULL;
 // -- Make sure we can't call show() too quickly
 CMinWait<50>   mWait;
 
+// -- When the last frame was completely sent, set by the interrupt handler.
+//    In double-buffered mode the reset time counts from there.
+static volatile uint32_t gDoneMicros = 0;
+static const uint32_t gResetMicros = 50;
+
 static bool gInitialized = false;
 
+// -- Return from show() without waiting for the data to be sent
+#if FASTLED_ESP32_FLASH_LOCK == 1
+static const bool gDoubleBuffered = false;
+#else
+static const bool gDoubleBuffered = FASTLED_RMT_DOUBLE_BUFFER && !FASTLED_RMT_BUILTIN_DRIVER;
+#endif
+
 // -- Stored values for FASTLED_RMT_MAX_CHANNELS and FASTLED_RMT_MEM_BLOCKS
 int ESP32RMTCustomController::gMaxChannel;
 int ESP32RMTCustomController::gMemBlocks;
@@ -33,6 +45,8 @@ int ESP32RMTCustomController::gMemBlocks;
 
 ESP32RMTCustomController::ESP32RMTCustomController(int DATA_PIN, int T1, int T2, int T3, int maxChannel, int memBlocks)
     : mPixelData(0),
+      mPixelBuffers{0, 0},
+      mBackBuffer(0),
       mSize(0),
       mCur(0),
       mWhichHalf(0),
@@ -78,11 +92,26 @@ ESP32RMTCustomController::ESP32RMTCustomController(int DATA_PIN, int T1, int T2,
 //    the PixelController object until show is called.
 uint8_t * ESP32RMTCustomController::getPixelBuffer(int size_in_bytes)
 {
-    if (mPixelData == 0) {
+    if (mPixelBuffers[0] == 0) {
         mSize = size_in_bytes;
-        mPixelData = (uint8_t *) malloc(mSize);
+        mPixelBuffers[0] = (uint8_t *) malloc(mSize);
+        if (gDoubleBuffered) {
+            mPixelBuffers[1] = (uint8_t *) malloc(mSize);
+        }
+        mPixelData = mPixelBuffers[0];
+    }
+    return mPixelBuffers[mBackBuffer];
+}
+
+// -- Make the last loaded buffer the one to transmit
+//    Only called once the previous frame is completely sent, so the
+//    old front buffer is free to be loaded with the next frame.
+void ESP32RMTCustomController::swapBuffers()
+{
+    mPixelData = mPixelBuffers[mBackBuffer];
+    if (gDoubleBuffered && mPixelBuffers[1] != 0) {
+        mBackBuffer ^= 1;
     }
-    return mPixelData;
 }
 
 // -- Initialize RMT subsystem
@@ -158,13 +187,29 @@ void IRAM_ATTR ESP32RMTCustomController::showPixels()
     // -- The last call to showPixels is the one responsible for doing
     //    all of the actual worl
     if (gNumStarted == gNumControllers) {
-        gNext = 0;
+        ledOutputStats.frames++;
 
-        // -- This Take always succeeds immediately
+        // -- In blocking mode this Take always succeeds immediately. In
+        //    double-buffered mode this is where we wait for the previous
+        //    frame, which was sent while the CPU rendered this one.
         xSemaphoreTake(gTX_sem, portMAX_DELAY);
 
-        // -- Make sure it's been at least 50us since last show
-        mWait.wait();
+        for (int i = 0; i < gNumControllers; i++) {
+            gControllers[i]->swapBuffers();
+        }
+
+        gNext = 0;
+        gNumDone = 0;
+
+        // -- Make sure it's been at least 50us since last show. The
+        //    previous frame usually finished while this one rendered, so
+        //    double-buffered mode rarely waits at all.
+        if (gDoubleBuffered) {
+            while (micros() - gDoneMicros < gResetMicros) {
+            }
+        } else {
+            mWait.wait();
+        }
 
         // -- First, fill all the available channels
         int channel = 0;
@@ -175,6 +220,15 @@ void IRAM_ATTR ESP32RMTCustomController::showPixels()
             channel += gMemBlocks;
         }
 
+        // -- Reset the counter of controllers loaded for this frame
+        gNumStarted = 0;
+
+        if (gDoubleBuffered) {
+            // -- Return right away. The interrupt handler keeps refilling
+            //    the RMT buffers and gives the semaphore back when done.
+            return;
+        }
+
         // -- Wait here while the data is sent. The interrupt handler
         //    will keep refilling the RMT buffers until it is all
         //    done; then it gives the semaphore back.
@@ -184,11 +238,6 @@ void IRAM_ATTR ESP32RMTCustomController::showPixels()
         // -- Make sure we don't call showPixels too quickly
         mWait.mark();
 
-        // -- Reset the counters
-        gNumStarted = 0;
-        gNumDone = 0;
-        gNext = 0;
-
 #if FASTLED_ESP32_FLASH_LOCK == 1
         // -- Release the lock on flash operations
         spi_flash_op_unlock();
@@ -290,6 +339,7 @@ void IRAM_ATTR ESP32RMTCustomController::doneOnChannel(rmt_channel_t channel, vo
     gNumDone++;
 
     if (gNumDone == gNumControllers) {
+        gDoneMicros = micros();
         // -- If this is the last controller, signal that we are all done
         if (FASTLED_RMT_BUILTIN_DRIVER) {
             xSemaphoreGive(gTX_sem);
@@ -364,6 +414,9 @@ void IRAM_ATTR ESP32RMTCustomController::fillNext(bool check_time)
                 RMT.conf_ch[mRMT_channel].conf1.mem_rd_rst = 1;
                 RMT.conf_ch[mRMT_channel].conf1.mem_rd_rst = 0;
                 */
+                if (mCur < mSize) {
+                    ledOutputStats.aborts++;
+                }
                 mCur = mSize;
             }
         }
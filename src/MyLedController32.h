@@ -76,9 +76,17 @@
  *      processing is done up-front, in the templated class, so we
  *      can fill the RMT buffers more quickly.
  *
- *      IN THEORY, this design would also allow FastLED.show() to
- *      send the data while the program continues to prepare the next
- *      frame of data.
+ *      This design also allows FastLED.show() to send the data while
+ *      the program continues to prepare the next frame of data: with
+ *      double buffering enabled each controller owns two pixel buffers,
+ *      show() returns as soon as the frame is queued, and only the next
+ *      show() waits for the previous transmission to finish. It is on by
+ *      default for the custom driver; to get fully blocking output back:
+ *
+ *      #define FASTLED_RMT_DOUBLE_BUFFER false
+ *
+ *      Double buffering is not used with FASTLED_RMT_BUILTIN_DRIVER or
+ *      FASTLED_ESP32_FLASH_LOCK, both of which need show() to block.
  *
  * Based on public domain code created 19 Nov 2016 by Chris Osborn <fozztexx@fozztexx.com>
  * http://insentricity.com *
@@ -110,6 +118,8 @@
     #define register
 #endif
 #include <FastLED.h>
+#include "LedOutputStats.h"
+#include "LedCorrection.h"
 
 static uint8_t ledPin = 0;
 
@@ -198,6 +208,11 @@ extern void spi_flash_op_unlock(void);
 #define FASTLED_RMT_MAX_CHANNELS 8
 #endif
 
+// -- Send one frame while the next one is prepared
+#ifndef FASTLED_RMT_DOUBLE_BUFFER
+#define FASTLED_RMT_DOUBLE_BUFFER true
+#endif
+
 class ESP32RMTCustomController
 {
 private:
@@ -219,7 +234,11 @@ private:
     uint32_t       mLastFill;
 
     // -- Pixel data
+    //    mPixelData is the buffer being sent, getPixelBuffer hands out the
+    //    other one when double buffering is enabled
     uint8_t *      mPixelData;
+    uint8_t *      mPixelBuffers[2];
+    int            mBackBuffer;
     int            mSize;
     int            mCur;
 
@@ -250,8 +269,12 @@ public:
     uint32_t IRAM_ATTR getMaxCyclesPerFill() const { return mMaxCyclesPerFill; }
 
     // -- Get or create the pixel data buffer
+    //    In double-buffered mode this is the buffer not being transmitted
     uint8_t * getPixelBuffer(int size_in_bytes);
 
+    // -- Make the last loaded buffer the one to transmit
+    void swapBuffers();
+
     // -- Initialize RMT subsystem
     //    This only needs to be done once. The particular pin is not important,
     //    because we need to configure the RMT channels on the fly.
@@ -333,7 +356,8 @@ protected:
     // -- Load pixel data
     //    This method loads all of the pixel data into a separate buffer for use by
     //    by the RMT driver. Copying does two important jobs: it fixes the color
-    //    order for the pixels, and it performs the scaling/adjusting ahead of time.
+    //    order for the pixels, and it performs the gamma correction and
+    //    scaling/adjusting ahead of time.
     //    It also packs the bytes into 32 bit chunks with the right bit order.
     void loadPixelData(PixelController<RGB_ORDER> & pixels)
     {
@@ -343,9 +367,9 @@ protected:
 
         // -- This might be faster
         while (pixels.has(1)) {
-            *pData++ = pixels.loadAndScale0();
-            *pData++ = pixels.loadAndScale1();
-            *pData++ = pixels.loadAndScale2();
+            *pData++ = loadCorrectAndScale<0>(pixels);
+            *pData++ = loadCorrectAndScale<1>(pixels);
+            *pData++ = loadCorrectAndScale<2>(pixels);
             pixels.advanceData();
             pixels.stepDithering();
         }
@@ -378,11 +402,11 @@ protected:
 
         uint32_t byteval;
         while (pixels.has(1)) {
-            byteval = pixels.loadAndScale0();
+            byteval = loadCorrectAndScale<0>(pixels);
             mRMTController.convertByte(byteval);
-            byteval = pixels.loadAndScale1();
+            byteval = loadCorrectAndScale<1>(pixels);
             mRMTController.convertByte(byteval);
-            byteval = pixels.loadAndScale2();
+            byteval = loadCorrectAndScale<2>(pixels);
             mRMTController.convertByte(byteval);
             pixels.advanceData();
             pixels.stepDithering();
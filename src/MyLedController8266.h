@@ -3,6 +3,9 @@
 #define register
 #endif
 #include <FastLED.h>
+#include "LedOutputStats.h"
+#include "LedCorrection.h"
+#include "UartSymbols.h"
 
 static uint8_t ledPin = 0;
 
@@ -13,6 +16,11 @@ public:
     {
         ledPin = pinNum;
     }
+
+    static uint8_t getLedPin()
+    {
+        return ledPin;
+    }
 };
 
 FASTLED_NAMESPACE_BEGIN
@@ -60,16 +68,21 @@ protected:
     virtual void showPixels(PixelController<RGB_ORDER>& pixels)
     {
         // mWait.wait();
+        ++ledOutputStats.frames;
         int cnt = FASTLED_INTERRUPT_RETRY_COUNT;
         while ((showRGBInternal(pixels) == 0) && cnt--) {
 #ifdef FASTLED_DEBUG_COUNT_FRAME_RETRIES
             _retry_cnt++;
 #endif
+            ++ledOutputStats.retries;
             os_intr_unlock();
             delayMicroseconds(WAIT_TIME);
             os_intr_lock();
+        }
+        if (cnt < 0) {
+            ++ledOutputStats.aborts;
+        }
     }
-}
 
     template<int BITS>
     __attribute__((always_inline)) inline void writeBits(uint32_t& last_mark, uint32_t b)
@@ -95,7 +108,7 @@ protected:
     {
         // Setup the pixel controller and load/scale the first byte
         pixels.preStepFirstByteDithering();
-        uint32_t b = pixels.loadAndScale0();
+        uint32_t b = loadCorrectAndScale<0>(pixels);
         pixels.preStepFirstByteDithering();
         os_intr_lock();
         uint32_t start = __clock_custom_cycles();
@@ -103,15 +116,16 @@ protected:
         while (pixels.has(1)) {
             // Write first byte, read next byte
             writeBits<8>(last_mark, b);
-            b = pixels.loadAndScale1();
+            b = loadCorrectAndScale<1>(pixels);
 
             // Write second byte, read 3rd byte
             writeBits<8>(last_mark, b);
-            b = pixels.loadAndScale2();
+            b = loadCorrectAndScale<2>(pixels);
 
             // Write third byte, read 1st byte of next pixel
             writeBits<8>(last_mark, b);
-            b = pixels.advanceAndLoadAndScale0();
+            pixels.advanceData();
+            b = loadCorrectAndScale<0>(pixels);
 
 #if (FASTLED_ALLOW_INTERRUPTS == 1)
             os_intr_unlock();
@@ -139,4 +153,104 @@ protected:
     }
 };
 
+// UART1 output: the UART shapes the timing from characters encoded by
+// encodeUartSymbols(), so interrupts stay enabled. UART1 TX is GPIO2 only.
+static const uint8_t uartPin = 2;
+static const uint32_t uartBaud = 3200000;
+static const uint8_t uartFifoSize = 128;
+// FIFO level that triggers a refill, leaves 80 characters (200 us) of slack
+static const uint8_t uartRefillThreshold = 80;
+// a full FIFO drains in 128 * 2.5 us, then leds need 300 us low to latch
+static const uint32_t uartDrainAndLatchUs = uartFifoSize * 5 / 2 + 300;
+
+static uint8_t* uartFrame = nullptr;
+static size_t uartFrameSize = 0;
+static const uint8_t* volatile uartFramePos = nullptr;
+static const uint8_t* volatile uartFrameEnd = nullptr;
+static volatile uint32_t uartFrameQueued = 0;
+
+static void ICACHE_RAM_ATTR uartIsr(void*)
+{
+    if (USIS(UART1) & (1 << UIFE)) {
+        const uint8_t* pos = uartFramePos;
+        const uint8_t* end = uartFrameEnd;
+        if (pos != uartFrame && ((USS(UART1) >> USTXC) & 0xff) == 0) {
+            // FIFO ran dry mid-frame, leds latched a partial frame
+            ++ledOutputStats.aborts;
+        }
+        while (pos < end && ((USS(UART1) >> USTXC) & 0xff) < uartFifoSize) {
+            USF(UART1) = *pos++;
+        }
+        uartFramePos = pos;
+        if (pos == end) {
+            USIE(UART1) &= ~(1 << UIFE);
+            uartFrameQueued = system_get_time();
+        }
+    }
+    USIC(UART1) = 0xffff;
+    // UART0 shares the interrupt, its rx interrupts are off since init()
+    USIC(UART0) = 0xffff;
+}
+
+template <EOrder RGB_ORDER = RGB>
+class Uart1CustomController : public CPixelLEDController<RGB_ORDER> {
+public:
+    virtual void init()
+    {
+#ifdef USE_DEBUG
+        Serial.println(F("Using UART1 led output on pin 2"));
+#endif
+        Serial1.begin(uartBaud, SERIAL_6N1, SERIAL_TX_ONLY);
+        USC0(UART1) |= (1 << UCTXI);
+        USC1(UART1) = (uartRefillThreshold << UCFET);
+        USIE(UART1) = 0;
+        USIC(UART1) = 0xffff;
+        // the attached handler replaces the one of Serial, which then
+        // can only transmit
+        USIE(UART0) = 0;
+        USIC(UART0) = 0xffff;
+        ETS_UART_INTR_ATTACH(uartIsr, nullptr);
+        ETS_UART_INTR_ENABLE();
+    }
+
+    virtual uint16_t getMaxRefreshRate() const
+    {
+        return 400;
+    }
+
+protected:
+
+    virtual void showPixels(PixelController<RGB_ORDER>& pixels)
+    {
+        // the previous frame is sent from the interrupt, only the encoding
+        // buffer has to be free again
+        while (uartFramePos != uartFrameEnd) {
+        }
+        while (system_get_time() - uartFrameQueued < uartDrainAndLatchUs) {
+        }
+
+        // 12 characters per led outgrow 16 bits from 5462 leds on
+        const size_t size = size_t(pixels.size()) * 3 * 4;
+        if (size > uartFrameSize) {
+            delete[] uartFrame;
+            uartFrame = new uint8_t[size];
+            uartFrameSize = size;
+        }
+
+        uint8_t* out = uartFrame;
+        while (pixels.has(1)) {
+            out = encodeUartSymbols(loadCorrectAndScale<0>(pixels), out);
+            out = encodeUartSymbols(loadCorrectAndScale<1>(pixels), out);
+            out = encodeUartSymbols(loadCorrectAndScale<2>(pixels), out);
+            pixels.advanceData();
+            pixels.stepDithering();
+        }
+
+        ++ledOutputStats.frames;
+        uartFrameEnd = out;
+        uartFramePos = uartFrame;
+        USIE(UART1) |= (1 << UIFE);
+    }
+};
+
 FASTLED_NAMESPACE_END
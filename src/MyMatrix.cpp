@@ -1,20 +1,297 @@
 #include "MyMatrix.h"
 #include "Settings.h"
+#include "LedCorrection.h"
+#include "LedOutputStats.h"
+#include "LedStrips.h"
 
-#if defined(ESP8266)
+// the native host build has no led output, frames stay in memory
+#if defined(NATIVE)
+#elif defined(ESP8266)
 #include "MyLedController8266.h"
 #else
 #include "MyLedController32.h"
 #endif
 
+LedOutputStats ledOutputStats;
+
 namespace {
 
     uint16_t numLeds = 0;
 
+    // leds is where effects draw, outputLeds is the frame that gets shown,
+    // controllerLeds is what the controllers send (outputLeds unless
+    // precision output is on)
     CRGB* leds = nullptr;
+    CRGB* outputLeds = nullptr;
+    CRGB* controllerLeds = nullptr;
 
     MyMatrix* object = nullptr;
 
+    // Checksum of the last frame sent by showIfChanged()
+    uint32_t frameChecksum = 0;
+    bool frameChecksumValid = false;
+    uint32_t frameShowTime = 0;
+    // Unchanged frames are refreshed this often while dithering, derived
+    // from the time the strip needs to take a frame and the configured cap
+    uint32_t ditherRefreshInterval = 20;
+    // No refreshes for this long after network traffic, see noteNetworkActivity()
+    uint32_t ditherBackoff = 0;
+    volatile uint32_t networkActivityTime = 0;
+    volatile bool networkActivity = false;
+
+    uint32_t shownFrameCount = 0;
+    uint32_t ditherRefreshCount = 0;
+    uint32_t ditherBackoffCount = 0;
+
+    // Precision output: every channel is expanded to 16 bits with gamma,
+    // white point and brightness applied, then rounded to 8 bits. The
+    // rounding error is carried into the next frame of the same pixel, so
+    // levels between two 8 bit steps show up as their average over time.
+    bool precision = false;
+    uint16_t precisionTable[3][256];
+    uint8_t* precisionError = nullptr;
+    // Fraction below the 8 bit draw buffer of every channel, kept by
+    // dimAll(), fadeToBlackBy() and fader() in precision mode and read by
+    // the output stage, so repeated fades run in 16 bits instead of
+    // dropping up to a step per frame. Pixels drawn over keep theirs, that
+    // is at most one 8 bit step.
+    uint8_t* fadeFraction = nullptr;
+
+    void buildPrecisionTable(float gamma, const uint8_t* white)
+    {
+        for (uint8_t channel = 0; channel < 3; ++channel) {
+            for (uint16_t value = 0; value < 256; ++value) {
+                const float corrected = powf(value / 255.0f, gamma);
+                precisionTable[channel][value] = static_cast<uint16_t>(corrected * white[channel] * 257.0f + 0.5f);
+            }
+        }
+    }
+
+    void ditherPrecisionFrame(uint8_t brightness)
+    {
+        const uint16_t scale = brightness + 1;
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(outputLeds);
+        uint8_t* out = reinterpret_cast<uint8_t*>(controllerLeds);
+        const uint32_t size = numLeds * 3;
+        uint8_t channel = 0;
+        for (uint32_t i = 0; i < size; ++i) {
+            uint32_t level = precisionTable[channel][in[i]];
+            if (fadeFraction[i] != 0 && in[i] < 255) {
+                level += ((precisionTable[channel][in[i] + 1] - level) * fadeFraction[i]) >> 8;
+            }
+            const uint32_t value = ((level * scale) >> 8) + precisionError[i];
+            if (value > 0xFFFF) {
+                out[i] = 255;
+                precisionError[i] = 0;
+            }
+            else {
+                out[i] = value >> 8;
+                precisionError[i] = value & 0xFF;
+            }
+            if (++channel == 3) {
+                channel = 0;
+            }
+        }
+    }
+
+    // Fades of the frame that is shown carry their fraction, offscreen
+    // buffers of transitions and renders don't
+    bool carryFades()
+    {
+        return fadeFraction && leds == outputLeds;
+    }
+
+    // scale is 1..256 as in FastLED's nscale8(scale - 1)
+    void scaleWithFraction(uint16_t index, uint16_t scale)
+    {
+        uint8_t* channels = leds[index].raw;
+        uint8_t* fraction = fadeFraction + index * 3;
+        for (uint8_t channel = 0; channel < 3; ++channel) {
+            const uint32_t value = ((uint32_t(channels[channel]) << 8 | fraction[channel]) * scale) >> 8;
+            channels[channel] = value >> 8;
+            fraction[channel] = value & 0xFF;
+        }
+    }
+
+    void clearFractions()
+    {
+        if (carryFades()) {
+            memset(fadeFraction, 0, numLeds * 3);
+        }
+    }
+
+    // Both dithering modes only work when frames keep coming
+    bool refreshFrames()
+    {
+        return precision || mySettings->matrixSettings.dither;
+    }
+
+    // Current limiting. FastLED's power function would scan the whole
+    // frame again on every show, so the estimate is taken here in the pass
+    // that already walks the frame and only reused by dither refreshes.
+    // Per channel mW at full level follow FastLED's WS2812 model at 5 V.
+    const uint32_t redMilliwatts = 16 * 5;
+    const uint32_t greenMilliwatts = 11 * 5;
+    const uint32_t blueMilliwatts = 15 * 5;
+    const uint32_t darkMilliwatts = 1 * 5;
+    const uint32_t mcuMilliwatts = 25 * 5;
+    uint32_t maxMilliwatts = 0;
+    // unscaled power of the current frame at brightness 255
+    uint32_t frameMilliwatts = 0;
+    // estimate for the last frame sent, at the brightness it was sent with
+    uint32_t lastFrameMilliamps = 0;
+
+    // One pass over the output frame: FNV-1a hash (same as
+    // MyMatrix::hashFrame()) and the power estimate
+    uint32_t measureFrame(uint32_t hash)
+    {
+        uint32_t red = 0;
+        uint32_t green = 0;
+        uint32_t blue = 0;
+        for (uint16_t i = 0; i < numLeds; ++i) {
+            const CRGB& pixel = outputLeds[i];
+            red += pixel.r;
+            green += pixel.g;
+            blue += pixel.b;
+            hash = (hash ^ pixel.r) * 16777619u;
+            hash = (hash ^ pixel.g) * 16777619u;
+            hash = (hash ^ pixel.b) * 16777619u;
+        }
+        frameMilliwatts = ((red * redMilliwatts + green * greenMilliwatts + blue * blueMilliwatts) >> 8)
+            + numLeds * darkMilliwatts + mcuMilliwatts;
+        return hash;
+    }
+
+    uint8_t limitBrightness(uint8_t brightness)
+    {
+        uint32_t requested = static_cast<uint32_t>((static_cast<uint64_t>(frameMilliwatts) * brightness) >> 8);
+        if (requested > maxMilliwatts) {
+            brightness = static_cast<uint64_t>(brightness) * maxMilliwatts / requested;
+            requested = maxMilliwatts;
+        }
+        lastFrameMilliamps = requested / 5;
+        return brightness;
+    }
+
+    void sendFrame()
+    {
+        const uint8_t brightness = limitBrightness(FastLED.getBrightness());
+        if (precision) {
+            // brightness is already in the dithered frame
+            ditherPrecisionFrame(brightness);
+            FastLED.show(255);
+        }
+        else {
+            FastLED.show(brightness);
+        }
+    }
+
+    // Physical led index for every unrotated (x, y) of a tiled matrix,
+    // row-major. Installed as Framebuffer_GFX remap function, so drawPixel()
+    // and everything drawn through it (lines, rects, text) look the tiles
+    // up here instead of working them out per pixel. Also folded into the
+    // XY table, so tiles cost nothing extra there either. A single panel
+    // has the stock NeoMatrix wiring and only the XY table.
+    uint16_t* panelMap = nullptr;
+    uint8_t panelMapWidth = 0;
+
+    uint16_t remapPanel(uint16_t x, uint16_t y)
+    {
+        return panelMap[y * panelMapWidth + x];
+    }
+
+    // Offset of (x, y) inside a w x h grid wired as described by NEO_MATRIX_* flags
+    uint16_t panelOffset(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t flags)
+    {
+        if (flags & NEO_MATRIX_RIGHT) {
+            x = w - 1 - x;
+        }
+        if (flags & NEO_MATRIX_BOTTOM) {
+            y = h - 1 - y;
+        }
+        const bool zigzag = (flags & NEO_MATRIX_SEQUENCE) == NEO_MATRIX_ZIGZAG;
+        if ((flags & NEO_MATRIX_AXIS) == NEO_MATRIX_ROWS) {
+            if (zigzag && (y & 1)) {
+                x = w - 1 - x;
+            }
+            return y * w + x;
+        }
+        if (zigzag && (x & 1)) {
+            y = h - 1 - y;
+        }
+        return x * h + y;
+    }
+
+    // Low nibble of type wires pixels inside each tile, high nibble
+    // (NEO_TILE_*) orders the tiles. Returns false for a single plain panel.
+    bool buildTileMap(uint8_t width, uint8_t height, uint8_t type)
+    {
+        const Settings::MatrixSettings& settings = mySettings->matrixSettings;
+        const uint8_t segments = settings.segments > 0 ? settings.segments : 1;
+        if (segments == 1 && settings.tileRotation.empty()) {
+            return false;
+        }
+
+        const uint8_t columns = settings.tileColumns > 0 ? settings.tileColumns : segments;
+        const uint8_t rows = segments / columns;
+        if (rows * columns != segments || width % columns != 0 || height % rows != 0) {
+#ifdef USE_DEBUG
+            Serial.printf_P(PSTR("Can't split %ux%u matrix into %u tiles by %u, using single panel\n"),
+                width, height, segments, columns);
+#endif
+            return false;
+        }
+
+        const uint8_t tileWidth = width / columns;
+        const uint8_t tileHeight = height / rows;
+        const uint16_t tileSize = tileWidth * tileHeight;
+        const uint8_t pixelFlags = type & 0x0F;
+        const uint8_t tileFlags = type >> 4;
+#ifdef USE_DEBUG
+        Serial.printf_P(PSTR("Tiled matrix: %u x %u tiles of %ux%u\n"), columns, rows, tileWidth, tileHeight);
+#endif
+
+        panelMap = new uint16_t[width * height];
+        panelMapWidth = width;
+        for (uint8_t y = 0; y < height; ++y) {
+            for (uint8_t x = 0; x < width; ++x) {
+                const uint16_t tile = panelOffset(x / tileWidth, y / tileHeight, columns, rows, tileFlags);
+                uint8_t rotation = tile < settings.tileRotation.size() ? settings.tileRotation[tile] : 0;
+                if ((rotation & 1) && tileWidth != tileHeight) {
+                    // quarter turns only fit square tiles
+                    rotation = 0;
+                }
+
+                const uint8_t lx = x % tileWidth;
+                const uint8_t ly = y % tileHeight;
+                uint8_t px = lx;
+                uint8_t py = ly;
+                switch (rotation) {
+                case 1:
+                    px = ly;
+                    py = tileWidth - 1 - lx;
+                    break;
+                case 2:
+                    px = tileWidth - 1 - lx;
+                    py = tileHeight - 1 - ly;
+                    break;
+                case 3:
+                    px = tileHeight - 1 - ly;
+                    py = lx;
+                    break;
+                }
+                panelMap[y * width + x] = tile * tileSize + panelOffset(px, py, tileWidth, tileHeight, pixelFlags);
+            }
+        }
+        return true;
+    }
+
+    uint32_t frameHash()
+    {
+        // output brightness and pixel data
+        return measureFrame((2166136261u ^ FastLED.getBrightness()) * 16777619u);
+    }
+
     const TProgmemRGBPalette16 WaterfallColors_p FL_PROGMEM = {
       0x000000, 0x060707, 0x101110, 0x151717,
       0x1C1D22, 0x242A28, 0x363B3A, 0x313634,
@@ -82,11 +359,77 @@ uint16_t XY(uint8_t x, uint8_t y) {
     return object->XY(x, y);
 }
 
+#if !defined(NATIVE)
 template <EOrder RGB_ORDER = RGB>
 class WS2812CustomController : public ClocklessCustomController<C_NS(250), C_NS(625), C_NS(375), RGB_ORDER> {};
+#endif
 
 FASTLED_NAMESPACE_END
 
+#if !defined(NATIVE)
+namespace {
+
+    template <EOrder ORDER>
+    void addStrips()
+    {
+#if defined(ESP32)
+        // Every pin gets its own controller and RMT channel, the driver
+        // sends all of them at once
+        const std::vector<uint8_t>& pins = mySettings->matrixSettings.pins;
+        if (pins.size() > 1) {
+            const uint8_t strips = pins.size();
+            for (uint8_t strip = 0; strip < strips; ++strip) {
+                const uint16_t first = stripStart(strip, strips, numLeds);
+                const uint16_t count = stripLength(strip, strips, numLeds);
+#ifdef USE_DEBUG
+                Serial.printf_P(PSTR("Strip %u on pin %u: leds %u..%u\n"), strip, pins[strip], first, first + count - 1);
+#endif
+                PinHolder::setLedPin(pins[strip]);
+                FastLED.addLeds(new WS2812CustomController<ORDER>(), controllerLeds + first, count);
+            }
+            return;
+        }
+#else
+        if (mySettings->matrixSettings.driver == 1) {
+            if (PinHolder::getLedPin() == uartPin) {
+                FastLED.addLeds<Uart1CustomController, ORDER>(controllerLeds, numLeds);
+                return;
+            }
+#ifdef USE_DEBUG
+            Serial.printf_P(PSTR("UART1 led output needs pin %u, using bit-bang\n"), uartPin);
+#endif
+        }
+#endif
+        FastLED.addLeds<WS2812CustomController, ORDER>(controllerLeds, numLeds);
+    }
+
+    // Color order is resolved once into the controller template, so the
+    // framebuffer always holds plain RGB and no per-pixel swapping is needed
+    void addLeds(const String& order)
+    {
+        if (order == F("rbg")) {
+            addStrips<RBG>();
+        }
+        else if (order == F("grb")) {
+            addStrips<GRB>();
+        }
+        else if (order == F("gbr")) {
+            addStrips<GBR>();
+        }
+        else if (order == F("brg")) {
+            addStrips<BRG>();
+        }
+        else if (order == F("bgr")) {
+            addStrips<BGR>();
+        }
+        else {
+            addStrips<RGB>();
+        }
+    }
+
+} // namespace
+#endif
+
 MyMatrix* MyMatrix::instance()
 {
     return object;
@@ -102,14 +445,50 @@ void MyMatrix::Initialize()
     Serial.println(F("Initializing MyMatrix"));
 #endif
 
+#if defined(NATIVE)
+#elif defined(ESP32)
+    const std::vector<uint8_t>& pins = mySettings->matrixSettings.pins;
+    PinHolder::setLedPin(pins.empty() ? mySettings->matrixSettings.pin : pins[0]);
+#else
+    // ESP8266 ignores the pin list
     PinHolder::setLedPin(mySettings->matrixSettings.pin);
+#endif
     uint8_t sizeWidth = mySettings->matrixSettings.width;
     uint8_t sizeHeight = mySettings->matrixSettings.height;
     uint8_t matrixType = mySettings->matrixSettings.type;
 
     numLeds = sizeWidth * sizeHeight;
     leds = new CRGB[numLeds]();
-    FastLED.addLeds<WS2812CustomController, RGB>(leds, numLeds);
+    outputLeds = leds;
+    controllerLeds = leds;
+    precision = mySettings->matrixSettings.precision;
+    if (precision) {
+#ifdef USE_DEBUG
+        Serial.println(F("Using precision output"));
+#endif
+        controllerLeds = new CRGB[numLeds]();
+        precisionError = new uint8_t[numLeds * 3]();
+        fadeFraction = new uint8_t[numLeds * 3]();
+    }
+#if !defined(NATIVE)
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Set color order to: %s\n"), mySettings->matrixSettings.order.c_str());
+#endif
+    addLeds(mySettings->matrixSettings.order);
+#endif
+
+    const uint8_t* whitePoint = mySettings->matrixSettings.whitePoint;
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Set gamma to: %.2f, white point: %u %u %u\n"),
+        mySettings->matrixSettings.gamma, whitePoint[0], whitePoint[1], whitePoint[2]);
+#endif
+    if (precision) {
+        buildPrecisionTable(mySettings->matrixSettings.gamma, whitePoint);
+        FastLED.setDither(DISABLE_DITHER);
+    }
+    else {
+        ledCorrection.build(mySettings->matrixSettings.gamma, CRGB(whitePoint[0], whitePoint[1], whitePoint[2]));
+    }
 
     uint8_t maxBrightness = mySettings->matrixSettings.maxBrightness;
 #ifdef USE_DEBUG
@@ -121,14 +500,33 @@ void MyMatrix::Initialize()
 #ifdef USE_DEBUG
     Serial.printf_P(PSTR("Set current limit to: %u\n"), currentLimit);
 #endif
-    FastLED.setMaxPowerInVoltsAndMilliamps(5, currentLimit);
+    maxMilliwatts = currentLimit * 5;
 
     uint8_t dither = mySettings->matrixSettings.dither ? 1 : 0;
+    // 30 us per led plus latch, twice that leaves the cpu and network
+    // at least half of the time between refreshes
+    uint8_t strips = 1;
+#if defined(ESP32)
+    if (mySettings->matrixSettings.pins.size() > 1) {
+        strips = mySettings->matrixSettings.pins.size();
+    }
+#endif
+    const uint32_t transmitTime = (numLeds * 30UL / strips + 300) / 1000 + 1;
+    ditherRefreshInterval = 2 * transmitTime;
+    const uint8_t ditherRate = mySettings->matrixSettings.ditherRate;
+    if (ditherRate > 0 && 1000 / ditherRate > ditherRefreshInterval) {
+        ditherRefreshInterval = 1000 / ditherRate;
+    }
+    ditherBackoff = mySettings->matrixSettings.ditherBackoff;
 #ifdef USE_DEBUG
-    Serial.printf_P(PSTR("Set dither: %u\n"), dither);
+    Serial.printf_P(PSTR("Set dither: %u, refresh every %u ms, backoff %u ms\n"),
+        dither, ditherRefreshInterval, ditherBackoff);
 #endif
 
     object = new MyMatrix(leds, sizeWidth, sizeHeight, matrixType);
+    if (buildTileMap(sizeWidth, sizeHeight, matrixType)) {
+        object->setRemapFunction(remapPanel);
+    }
     uint8_t rotation = mySettings->matrixSettings.rotation;
 #ifdef USE_DEBUG
     Serial.printf_P(PSTR("Set rotation to: %u\n"), rotation);
@@ -138,6 +536,11 @@ void MyMatrix::Initialize()
     object->begin();
     object->clear();
     object->show();
+
+#ifdef USE_DEBUG
+    benchmarkXY(16, 16);
+    benchmarkXY(32, 32);
+#endif
 }
 
 uint8_t MyMatrix::getRotation()
@@ -145,6 +548,12 @@ uint8_t MyMatrix::getRotation()
     return rotation;
 }
 
+void MyMatrix::setRotation(uint8_t r)
+{
+    FastLED_NeoMatrix::setRotation(r);
+    buildXYTable();
+}
+
 uint16_t MyMatrix::getNumLeds()
 {
     return numLeds;
@@ -185,19 +594,84 @@ CRGB* MyMatrix::getLeds()
     return leds;
 }
 
+uint32_t MyMatrix::hashFrame(const CRGB* buffer, uint32_t hash)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer);
+    const uint32_t size = numLeds * sizeof(CRGB);
+    for (uint32_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void MyMatrix::setDrawBuffer(CRGB* buffer)
+{
+    leds = buffer ? buffer : outputLeds;
+    newLedsPtr(leds);
+}
+
 void MyMatrix::setCurrentLimit(uint32_t maxCurrent)
 {
-    FastLED.setMaxPowerInVoltsAndMilliamps(5, maxCurrent);
+    maxMilliwatts = maxCurrent * 5;
+    frameChecksumValid = false;
 }
 
 MyMatrix::MyMatrix(CRGB* leds, uint8_t w, uint8_t h, uint8_t matrixType)
     : FastLED_NeoMatrix(leds, w, h, 1, 1, matrixType)
 {
+    xyTable = new uint16_t[w * h];
+    buildXYTable();
+}
+
+MyMatrix::~MyMatrix()
+{
+    delete[] xyTable;
+}
+
+void MyMatrix::buildXYTable()
+{
+    // rotation is resolved once here instead of per pixel, the wiring comes
+    // in through the remap function once Initialize() installed it
+    for (int16_t y = 0; y < _height; ++y) {
+        for (int16_t x = 0; x < _width; ++x) {
+            xyTable[y * _width + x] = static_cast<uint16_t>(FastLED_NeoMatrix::XY(x, y));
+        }
+    }
+}
+
+#ifdef USE_DEBUG
+void MyMatrix::benchmarkXY(uint8_t w, uint8_t h)
+{
+    // pixel buffer is never touched by XY(), so any pointer will do
+    MyMatrix matrix(leds, w, h, mySettings->matrixSettings.type);
+    matrix.setRotation(mySettings->matrixSettings.rotation);
+
+    uint32_t checksum = 0;
+    uint32_t start = ESP.getCycleCount();
+    for (int16_t y = 0; y < matrix.height(); ++y) {
+        for (int16_t x = 0; x < matrix.width(); ++x) {
+            checksum += matrix.FastLED_NeoMatrix::XY(x, y);
+        }
+    }
+    const uint32_t direct = ESP.getCycleCount() - start;
+
+    start = ESP.getCycleCount();
+    for (int16_t y = 0; y < matrix.height(); ++y) {
+        for (int16_t x = 0; x < matrix.width(); ++x) {
+            checksum -= matrix.XY(x, y);
+        }
+    }
+    const uint32_t cached = ESP.getCycleCount() - start;
+
+    Serial.printf_P(PSTR("XY benchmark %ux%u: %u cycles/frame direct, %u cycles/frame table, checksum %u\n"),
+        w, h, direct, cached, checksum);
 }
+#endif
 
 void MyMatrix::fill(CRGB color, bool shouldShow)
 {
-    fill_solid(leds, numLeds, swapChannels(color));
+    fill_solid(leds, numLeds, color);
+    clearFractions();
     if (shouldShow) {
         show();
     }
@@ -227,54 +701,32 @@ void MyMatrix::fillProgress(double progress)
     setPassThruColor();
     delay(1);
 
-    FastLED.show();
-}
-
-CRGB MyMatrix::swapChannels(CRGB color)
-{
-    if (mySettings->matrixSettings.order.length() != 3) {
-        return color;
-    }
-    CRGB result = color;
-    if (mySettings->matrixSettings.order.charAt(0) != 'r') {
-        if (mySettings->matrixSettings.order.charAt(0) == 'g') {
-            result.r = color.g;
-        }
-        else {
-            result.r = color.b;
-        }
-    }
-    if (mySettings->matrixSettings.order.charAt(1) != 'g') {
-        if (mySettings->matrixSettings.order.charAt(1) == 'r') {
-            result.g = color.r;
-        }
-        else {
-            result.g = color.b;
-        }
-    }
-    if (mySettings->matrixSettings.order.charAt(2) != 'b') {
-        if (mySettings->matrixSettings.order.charAt(2) == 'r') {
-            result.b = color.r;
-        }
-        else {
-            result.b = color.g;
-        }
-    }
-    return result;
+    measureFrame(0);
+    sendFrame();
 }
 
 void MyMatrix::setLed(uint16_t index, CRGB color)
 {
-    leds[index] = swapChannels(color);
+    leds[index] = color;
 }
 
 void MyMatrix::fadeToBlackBy(uint16_t index, uint8_t step)
 {
+    if (carryFades()) {
+        scaleWithFraction(index, 256 - step);
+        return;
+    }
     leds[index].fadeToBlackBy(step);
 }
 
 void MyMatrix::fadeToBlackBy(uint8_t step)
 {
+    if (carryFades()) {
+        for (uint16_t i = 0; i < numLeds; i++) {
+            scaleWithFraction(i, 256 - step);
+        }
+        return;
+    }
     for (uint16_t i = 0; i < numLeds; i++) {
         leds[i].fadeToBlackBy(step);
     }
@@ -282,6 +734,12 @@ void MyMatrix::fadeToBlackBy(uint8_t step)
 
 void MyMatrix::dimAll(uint8_t value)
 {
+    if (carryFades()) {
+        for (uint16_t i = 0; i < numLeds; i++) {
+            scaleWithFraction(i, value + 1);
+        }
+        return;
+    }
     for (uint16_t i = 0; i < numLeds; i++) {
         leds[i].nscale8(value);
     }
@@ -319,10 +777,13 @@ void MyMatrix::fadePixel(uint16_t i, uint8_t step)
     if (leds[i].r >= 30 ||
         leds[i].g >= 30 ||
         leds[i].b >= 30) {
-        leds[i].fadeToBlackBy(step);
+        fadeToBlackBy(i, step);
     }
     else {
         leds[i] = 0;
+        if (carryFades()) {
+            memset(fadeFraction + i * 3, 0, 3);
+        }
     }
 }
 
@@ -353,15 +814,100 @@ void MyMatrix::matrixTest()
     show();
 }
 
+void MyMatrix::show()
+{
+    // frames shown directly do not update the checksum, so force the next one out
+    frameChecksumValid = false;
+    measureFrame(0);
+    sendFrame();
+    frameShowTime = millis();
+    ++shownFrameCount;
+}
+
+void MyMatrix::refresh()
+{
+    // temporal dithering needs the frame repeated, but not faster than
+    // the strip takes it
+    const uint32_t now = millis();
+    if (!refreshFrames() || now - frameShowTime < ditherRefreshInterval) {
+        return;
+    }
+    // the output blocks interrupts on ESP8266, leave the network alone
+    // while it is busy
+    if (networkActivity) {
+        if (now - networkActivityTime < ditherBackoff) {
+            ++ditherBackoffCount;
+            frameShowTime = now;
+            return;
+        }
+        networkActivity = false;
+    }
+    sendFrame();
+    frameShowTime = now;
+    ++ditherRefreshCount;
+}
+
+void MyMatrix::noteNetworkActivity()
+{
+    networkActivityTime = millis();
+    networkActivity = true;
+}
+
+uint32_t MyMatrix::shownFrames()
+{
+    return shownFrameCount;
+}
+
+uint32_t MyMatrix::ditherRefreshes()
+{
+    return ditherRefreshCount;
+}
+
+uint32_t MyMatrix::ditherBackoffs()
+{
+    return ditherBackoffCount;
+}
+
+uint32_t MyMatrix::frameMilliamps()
+{
+    return lastFrameMilliamps;
+}
+
+void MyMatrix::showIfChanged()
+{
+    const uint32_t checksum = frameHash();
+    if (frameChecksumValid && checksum == frameChecksum) {
+        // static effects keep ticking, the frame is only sent again for
+        // dithering and with the same rate limit and network backoff
+        refresh();
+        return;
+    }
+
+    sendFrame();
+    frameChecksum = checksum;
+    frameChecksumValid = true;
+    frameShowTime = millis();
+    ++shownFrameCount;
+}
+
 void MyMatrix::clear(bool shouldShow)
 {
-    FastLED.clear();
+    fill_solid(leds, numLeds, CRGB::Black);
+    clearFractions();
     if (shouldShow) {
         delay(1);
         show();
     }
 }
 
+uint16_t MyMatrix::XY(int16_t x, int16_t y)
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height) {
+        return 0;
+    }
+    return xyTable[y * _width + x];
+}
+
 uint16_t MyMatrix::getPixelNumberXY(uint8_t x, uint8_t y)
 {
     return static_cast<uint16_t>(XY(y, x));
@@ -369,12 +915,12 @@ uint16_t MyMatrix::getPixelNumberXY(uint8_t x, uint8_t y)
 
 void MyMatrix::drawPixelXY(uint8_t x, uint8_t y, CRGB color)
 {
-    leds[myMatrix->getPixelNumberXY(x, y)] = swapChannels(color);
+    leds[myMatrix->getPixelNumberXY(x, y)] = color;
 }
 
 void MyMatrix::drawLineXY(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, CRGB color)
 {
-    setPassThruColor(swapChannels(color));
+    setPassThruColor(color);
     drawLine(y0, x0, y1, x1, 0);
     setPassThruColor();
 }
@@ -384,7 +930,7 @@ CRGB MyMatrix::getPixColor(uint16_t number)
     if (number > numLeds - 1) {
         return 0;
     }
-    return swapChannels(leds[number]);
+    return leds[number];
 }
 
 CRGB MyMatrix::getPixColorXY(uint8_t x, uint8_t y)
@@ -394,17 +940,17 @@ CRGB MyMatrix::getPixColorXY(uint8_t x, uint8_t y)
 
 void MyMatrix::tintPixelXY(uint8_t x, uint8_t y, CRGB color)
 {
-    leds[myMatrix->getPixelNumberXY(x, y)] += swapChannels(color);
+    leds[myMatrix->getPixelNumberXY(x, y)] += color;
 }
 
 void MyMatrix::shadePixelXY(uint8_t x, uint8_t y, CRGB color)
 {
-    leds[myMatrix->getPixelNumberXY(x, y)] -= swapChannels(color);
+    leds[myMatrix->getPixelNumberXY(x, y)] -= color;
 }
 
 void MyMatrix::blendPixelXY(uint8_t x, uint8_t y, const CRGB& color, uint8_t amount)
 {
-    nblend(leds[myMatrix->getPixelNumberXY(x, y)], swapChannels(color), amount);
+    nblend(leds[myMatrix->getPixelNumberXY(x, y)], color, amount);
 }
 
 void MyMatrix::dimPixelXY(uint8_t x, uint8_t y, uint8_t value)
@@ -414,7 +960,7 @@ void MyMatrix::dimPixelXY(uint8_t x, uint8_t y, uint8_t value)
 
 void MyMatrix::fillRectXY(uint8_t x, uint8_t y, uint8_t w, uint8_t h, CRGB color)
 {
-    setPassThruColor(swapChannels(color));
+    setPassThruColor(color);
     fillRect(y, x, h, w, 0);
     setPassThruColor();
 }
@@ -428,12 +974,7 @@ void MyMatrix::fadePixelXY(uint8_t x, uint8_t y, uint8_t step)
         return;
     }
 
-    if (color.r >= 30 || color.g >= 30 || color.b >= 30) {
-        myMatrix->fadeToBlackBy(pixelNum, step);
-    }
-    else {
-        myMatrix->setLed(pixelNum, CRGB::Black);
-    }
+    fadePixel(pixelNum, step);
 }
 
 void MyMatrix::getCharBounds(char c, int16_t* xx, int16_t* yy, uint16_t* ww, uint16_t* hh)
@@ -24,6 +24,7 @@ public:
     static void Initialize();
 
     uint8_t getRotation();
+    void setRotation(uint8_t r) override;
 
     const TProgmemRGBPalette16 *GetColorPalette(uint8_t pct);
     const CRGBPalette16 *GetFirePalette(uint8_t pct);
@@ -34,12 +35,26 @@ public:
     uint8_t getDimension();
 
     CRGB *getLeds();
+    void setDrawBuffer(CRGB *buffer);
+    // FNV-1a over a matrix sized pixel buffer
+    static uint32_t hashFrame(const CRGB *buffer, uint32_t hash = 2166136261u);
 
     void setCurrentLimit(uint32_t maxCurrent);
 
     void matrixTest();
 
-    CRGB swapChannels(CRGB color);
+    void show();
+    void showIfChanged();
+    // Shows the last frame again for temporal dithering, rate limited
+    void refresh();
+    // Called on incoming requests, pauses dither refreshes for ditherBackoff ms
+    static void noteNetworkActivity();
+
+    static uint32_t shownFrames();
+    static uint32_t ditherRefreshes();
+    static uint32_t ditherBackoffs();
+    // Estimated current of the last frame sent, after current limiting
+    static uint32_t frameMilliamps();
 
     void clear(bool shouldShow = false);
     void fill(CRGB color, bool shouldShow = false);
@@ -57,6 +72,7 @@ public:
     uint32_t colorcode(const CRGB &color);
     void applyBlur2d(uint8_t amount);
 
+    uint16_t XY(int16_t x, int16_t y);
     uint16_t getPixelNumberXY(uint8_t x, uint8_t y);
 
     void drawPixelXY(uint8_t x, uint8_t y, CRGB color);
@@ -78,4 +94,13 @@ public:
 
 protected:
     MyMatrix(CRGB *leds, uint8_t w, uint8_t h, uint8_t matrixType);
+    ~MyMatrix();
+
+    void buildXYTable();
+#ifdef USE_DEBUG
+    static void benchmarkXY(uint8_t w, uint8_t h);
+#endif
+
+    // (x, y) -> led index for current rotation, row-major by rotated width
+    uint16_t *xyTable = nullptr;
 };
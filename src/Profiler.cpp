@@ -0,0 +1,72 @@
+#ifdef USE_PROFILER
+#include "Profiler.h"
+
+void TimingStats::add(uint32_t us)
+{
+    ++count;
+    total += us;
+    if (us < min) {
+        min = us;
+    }
+    if (us > max) {
+        max = us;
+    }
+
+    uint8_t bucket = 0;
+    while (us > 1 && bucket < bucketsCount - 1) {
+        us >>= 1;
+        ++bucket;
+    }
+    if (buckets[bucket] < UINT16_MAX) {
+        ++buckets[bucket];
+    }
+}
+
+void TimingStats::reset()
+{
+    *this = TimingStats();
+}
+
+uint32_t TimingStats::average() const
+{
+    return count ? total / count : 0;
+}
+
+uint32_t TimingStats::percentile(uint8_t pct) const
+{
+    uint32_t samples = 0;
+    for (uint8_t bucket = 0; bucket < bucketsCount; ++bucket) {
+        samples += buckets[bucket];
+    }
+    if (samples == 0) {
+        return 0;
+    }
+
+    const uint32_t target = (samples * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < bucketsCount; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= target) {
+            return bucket == bucketsCount - 1 ? max : (2u << bucket) - 1;
+        }
+    }
+    return max;
+}
+
+void TimingStats::printJson(Print& out) const
+{
+    out.printf_P(PSTR("{\"count\":%u,\"min\":%u,\"avg\":%u,\"p95\":%u,\"max\":%u,\"histogram\":["),
+        count, count ? min : 0, average(), percentile(95), max);
+    for (uint8_t bucket = 0; bucket < bucketsCount; ++bucket) {
+        out.printf_P(bucket ? PSTR(",%u") : PSTR("%u"), buckets[bucket]);
+    }
+    out.print(F("]}"));
+}
+
+void EffectProfile::reset()
+{
+    tick.reset();
+    show.reset();
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+#include <Arduino.h>
+
+// Timing statistics collected per effect when built with -DUSE_PROFILER.
+// Without the flag Effect carries no stats and Process() is not instrumented.
+struct TimingStats
+{
+    // bucket k counts samples in [2^k, 2^(k+1)) microseconds, last one is open
+    static const uint8_t bucketsCount = 16;
+
+    uint32_t count = 0;
+    uint32_t total = 0;
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint16_t buckets[bucketsCount] = {};
+
+    void add(uint32_t us);
+    void reset();
+    uint32_t average() const;
+    // Upper bound of the bucket holding the requested percentile
+    uint32_t percentile(uint8_t pct) const;
+    void printJson(Print &out) const;
+};
+
+struct EffectProfile
+{
+    TimingStats tick;
+    TimingStats show;
+
+    void reset();
+};
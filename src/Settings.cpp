@@ -4,6 +4,8 @@
 #include "LocalDNS.h"
 #include "MqttClient.h"
 #include "LampWebServer.h"
+#include "SettingsSnapshot.h"
+#include "SettingsWriter.h"
 
 #include <ESPAsyncWebServer.h>
 
@@ -19,7 +21,8 @@
 namespace {
 
     const size_t serializeEffectsSize = 512 * 22;
-    const size_t serializeSettingsSize = 512 * 2;
+    const size_t serializeSettingsSize = 512 * 3;
+    const size_t serializeEffectSize = 768;
 
     Settings* object = nullptr;
 
@@ -33,6 +36,15 @@ namespace {
     const char* settingsFileNameSave PROGMEM = "/settings.json.save";
     const char* effectsFileNameSave PROGMEM = "/effects.json.save";
 
+    // fast boot syncs the files from their saves after the first frames
+    bool settingsCopyPending = false;
+    bool effectsCopyPending = false;
+    // snapshot is written again once the json files have been read
+    bool snapshotPending = false;
+
+    // longest a save kept loop() busy taking its buffers, us
+    uint32_t saveMicros = 0;
+
     std::vector<String> pendingConfig;
     std::vector<String> pendingCommand;
 
@@ -100,6 +112,57 @@ namespace {
         return true;
     }
 
+    // Brings the served json file up to date with its save, fast boot
+    // leaves it to Settings::loop()
+    void syncFile(bool& pending, const char* fileFrom, const char* fileTo)
+    {
+        if (mySettings->generalSettings.fastBoot) {
+            pending = true;
+            return;
+        }
+        copyFile(fileFrom, fileTo);
+    }
+
+    // Both json files, their served copies and a new snapshot, which
+    // empties the journal. Everything is serialized here and written by
+    // SettingsWriter, commands keep changing live state meanwhile.
+    void saveAll()
+    {
+        BufferPrint settingsJson;
+        {
+            DynamicJsonDocument json(serializeSettingsSize);
+            JsonObject root = json.to<JsonObject>();
+            mySettings->buildSettingsJson(root);
+            settingsJson.reserve(measureJson(json));
+            serializeJson(json, settingsJson);
+        }
+        const SettingsWriter::Buffer settingsBuffer = settingsJson.release();
+        SettingsWriter::replace(settingsFileNameSave, settingsBuffer);
+        SettingsWriter::replace(settingsFileName, settingsBuffer);
+
+        // one buffer per effect, the whole list would need one block of
+        // about 11 kB
+        SettingsWriter::Parts effectsParts;
+        effectsParts.reserve(effectsManager->count() + 1);
+        for (uint8_t index = 0; index < effectsManager->count(); ++index) {
+            DynamicJsonDocument json(serializeEffectSize);
+            JsonObject effect = json.to<JsonObject>();
+            mySettings->buildEffectJson(index, effect);
+            BufferPrint effectJson;
+            effectJson.reserve(measureJson(json) + 1);
+            effectJson.print(index == 0 ? '[' : ',');
+            serializeJson(json, effectJson);
+            effectsParts.push_back(effectJson.release());
+        }
+        BufferPrint effectsEnd;
+        effectsEnd.print(effectsParts.empty() ? F("[]") : F("]"));
+        effectsParts.push_back(effectsEnd.release());
+        SettingsWriter::replace(effectsFileNameSave, effectsParts);
+        SettingsWriter::replace(effectsFileName, effectsParts);
+
+        SettingsSnapshot::save();
+    }
+
     void restoreSettingsAndReboot()
     {
 #ifdef USE_DEBUG
@@ -146,26 +209,68 @@ size_t Settings::jsonSerializeSize()
 
 void Settings::loop()
 {
-    if (settingsChanged && settingsSaveTimer > 0 && (millis() - settingsSaveTimer) > settingsSaveInterval) {
-        settingsChanged = false;
-        settingsSaveTimer = millis();
-        saveSettings();
-        saveEffects();
-
-        if (pendingConfig.size()) {
-            for (const String& config : pendingConfig) {
-                processConfig(config);
+    SettingsWriter::loop();
+
+    // an uploaded json is read at next boot, saves would overwrite it
+    if (!SettingsSnapshot::discarded()) {
+        if (settingsCopyPending) {
+            settingsCopyPending = false;
+            SettingsWriter::copy(settingsFileNameSave, settingsFileName);
+        }
+        if (effectsCopyPending) {
+            effectsCopyPending = false;
+            SettingsWriter::copy(effectsFileNameSave, effectsFileName);
+        }
+        if (snapshotPending) {
+            snapshotPending = false;
+            SettingsSnapshot::save();
+        }
+
+        const uint32_t start = micros();
+        bool saved = false;
+        // compaction waits for earlier files, so they don't pile up in memory
+        if (SettingsSnapshot::journalFull() && SettingsWriter::idle()) {
+            saveAll();
+            saved = true;
+        }
+        if (settingsChanged && settingsSaveTimer > 0 && (millis() - settingsSaveTimer) > settingsSaveInterval) {
+            settingsChanged = false;
+            settingsSaveTimer = millis();
+            // small records for what changed, a full save only without a snapshot
+            if (!SettingsSnapshot::saveChanges()) {
+                saveAll();
             }
-            pendingConfig.clear();
+            saved = true;
         }
-
-        if (pendingCommand.size()) {
-            for (const String& command : pendingCommand) {
-                processCommandMqtt(command);
+        if (saved) {
+            const uint32_t elapsed = micros() - start;
+            if (elapsed > saveMicros) {
+                saveMicros = elapsed;
             }
-            pendingCommand.clear();
         }
     }
+
+    // only boot time writes still block, commands parked meanwhile run now
+    if (busy) {
+        return;
+    }
+    if (pendingConfig.size()) {
+        for (const String& config : pendingConfig) {
+            processConfig(config);
+        }
+        pendingConfig.clear();
+    }
+    if (pendingCommand.size()) {
+        for (const String& command : pendingCommand) {
+            processCommandMqtt(command);
+        }
+        pendingCommand.clear();
+    }
+}
+
+uint32_t Settings::maxSaveMicros()
+{
+    return saveMicros;
 }
 
 void Settings::saveLater()
@@ -187,6 +292,7 @@ void Settings::saveSettings()
 #ifdef USE_DEBUG
         Serial.println(F("Error opening settings file from FLASHFS!"));
 #endif
+        busy = false;
         return;
     }
 
@@ -224,6 +330,7 @@ void Settings::saveEffects()
 #ifdef USE_DEBUG
         Serial.println(F("Error opening effects file from FLASHFS!"));
 #endif
+        busy = false;
         return;
     }
 
@@ -249,8 +356,8 @@ void Settings::saveEffects()
 
 void Settings::writeEffectsMqtt(JsonArray& array)
 {
-    for (Effect* effect : effectsManager->effects) {
-        array.add(effect->settings.name);
+    for (uint8_t index = 0; index < effectsManager->count(); ++index) {
+        array.add(effectsManager->effectSettings(index).name);
     }
 }
 
@@ -297,7 +404,7 @@ void Settings::processConfig(const String& message)
         else if (event == F("EFFECTS_CHANGED")) {
             const JsonObject effect = doc[F("data")];
             const String id = effect[F("i")];
-            if (id == effectsManager->activeEffect()->settings.id) {
+            if (id == effectsManager->effectSettings(effectsManager->activeEffectIndex()).id) {
                 effectsManager->updateCurrentSettings(effect);
             }
             else {
@@ -374,6 +481,16 @@ void Settings::processCommandMqtt(const String& message)
 
 bool Settings::readSettings()
 {
+    SettingsWriter::recover(settingsFileName);
+    SettingsWriter::recover(settingsFileNameSave);
+    SettingsWriter::recover(effectsFileName);
+    SettingsWriter::recover(effectsFileNameSave);
+
+    // json files on flash match the snapshot, changes since are journaled
+    if (SettingsSnapshot::readSettings(this)) {
+        return true;
+    }
+
     bool settingsExists = FLASHFS.exists(settingsFileName);
 #ifdef USE_DEBUG
     Serial.printf_P(PSTR("FLASHFS Settings file exists: %s\n"), settingsExists ? PSTR("true") : PSTR("false"));
@@ -406,14 +523,12 @@ bool Settings::readSettings()
 
 #ifdef USE_DEBUG
     Serial.println("reading settings.json.save");
-#endif
     while (settings.available()) {
         String buffer = settings.readStringUntil('\n');
-#ifdef USE_DEBUG
         Serial.println(buffer);
-#endif
     }
     settings.seek(0);
+#endif
 
     DynamicJsonDocument json(serializeSettingsSize);
     DeserializationError err = deserializeJson(json, settings);
@@ -439,6 +554,12 @@ bool Settings::readSettings()
         if (matrixObject.containsKey(F("pin"))) {
             matrixSettings.pin = matrixObject[F("pin")];
         }
+        if (matrixObject.containsKey(F("pins"))) {
+            matrixSettings.pins.clear();
+            for (JsonVariant value : matrixObject[F("pins")].as<JsonArray>()) {
+                matrixSettings.pins.push_back(value.as<uint8_t>());
+            }
+        }
         if (matrixObject.containsKey(F("width"))) {
             matrixSettings.width = matrixObject[F("width")];
         }
@@ -448,6 +569,15 @@ bool Settings::readSettings()
         if (matrixObject.containsKey(F("segments"))) {
             matrixSettings.segments = matrixObject[F("segments")];
         }
+        if (matrixObject.containsKey(F("tileColumns"))) {
+            matrixSettings.tileColumns = matrixObject[F("tileColumns")];
+        }
+        if (matrixObject.containsKey(F("tileRotation"))) {
+            matrixSettings.tileRotation.clear();
+            for (JsonVariant value : matrixObject[F("tileRotation")].as<JsonArray>()) {
+                matrixSettings.tileRotation.push_back(value.as<uint8_t>() % 4);
+            }
+        }
         if (matrixObject.containsKey(F("type"))) {
             matrixSettings.type = matrixObject[F("type")];
         }
@@ -463,9 +593,30 @@ bool Settings::readSettings()
         if (matrixObject.containsKey(F("dither"))) {
             matrixSettings.dither = matrixObject[F("dither")];
         }
+        if (matrixObject.containsKey(F("ditherRate"))) {
+            matrixSettings.ditherRate = matrixObject[F("ditherRate")];
+        }
+        if (matrixObject.containsKey(F("ditherBackoff"))) {
+            matrixSettings.ditherBackoff = matrixObject[F("ditherBackoff")];
+        }
+        if (matrixObject.containsKey(F("precision"))) {
+            matrixSettings.precision = matrixObject[F("precision")];
+        }
         if (matrixObject.containsKey(F("order"))) {
             matrixSettings.order = matrixObject[F("order")].as<String>();
         }
+        if (matrixObject.containsKey(F("driver"))) {
+            matrixSettings.driver = matrixObject[F("driver")];
+        }
+        if (matrixObject.containsKey(F("gamma"))) {
+            matrixSettings.gamma = matrixObject[F("gamma")];
+        }
+        if (matrixObject.containsKey(F("whitePoint"))) {
+            JsonArray whitePointArray = matrixObject[F("whitePoint")];
+            for (uint8_t channel = 0; channel < 3 && channel < whitePointArray.size(); ++channel) {
+                matrixSettings.whitePoint[channel] = whitePointArray[channel];
+            }
+        }
     }
 
     if (root.containsKey(F("connection"))) {
@@ -548,6 +699,16 @@ bool Settings::readSettings()
         }
     }
 
+    if (root.containsKey(F("transition"))) {
+        JsonObject transitionObject = root[F("transition")];
+        if (transitionObject.containsKey(F("mode"))) {
+            generalSettings.transitionMode = transitionObject[F("mode")];
+        }
+        if (transitionObject.containsKey(F("frames"))) {
+            generalSettings.transitionFrames = transitionObject[F("frames")];
+        }
+    }
+
     if (root.containsKey(F("logInterval"))) {
         generalSettings.logInterval = root[F("logInterval")];
     }
@@ -560,13 +721,21 @@ bool Settings::readSettings()
         generalSettings.working = root[F("working")];
     }
 
-    copyFile(settingsFileNameSave, settingsFileName);
+    if (root.containsKey(F("fastBoot"))) {
+        generalSettings.fastBoot = root[F("fastBoot")];
+    }
+
+    syncFile(settingsCopyPending, settingsFileNameSave, settingsFileName);
 
     return true;
 }
 
 bool Settings::readEffects()
 {
+    if (SettingsSnapshot::readEffects()) {
+        return true;
+    }
+
     bool effectsExists = FLASHFS.exists(effectsFileName);
 #ifdef USE_DEBUG
     Serial.printf_P(PSTR("FLASHFS Effects file exists: %s\n"), effectsExists ? PSTR("true") : PSTR("false"));
@@ -575,6 +744,7 @@ bool Settings::readEffects()
         effectsManager->processAllEffects();
         saveEffects();
         copyFile(effectsFileNameSave, effectsFileName);
+        snapshotPending = true;
         return false;
     }
     bool effectsSaveExists = FLASHFS.exists(effectsFileNameSave);
@@ -599,14 +769,12 @@ bool Settings::readEffects()
 
 #ifdef USE_DEBUG
     Serial.println("reading effects.json");
-#endif
     while (effects.available()) {
         String buffer = effects.readStringUntil('\n');
-#ifdef USE_DEBUG
         Serial.println(buffer);
-#endif
     }
     effects.seek(0);
+#endif
 
     DynamicJsonDocument json(serializeEffectsSize);
     DeserializationError err = deserializeJson(json, effects);
@@ -635,7 +803,8 @@ bool Settings::readEffects()
         effectsManager->processEffectSettings(effect);
     }
 
-    copyFile(effectsFileNameSave, effectsFileName);
+    syncFile(effectsCopyPending, effectsFileNameSave, effectsFileName);
+    snapshotPending = true;
 
     return true;
 }
@@ -645,18 +814,37 @@ void Settings::buildSettingsJson(JsonObject& root)
     root[F("activeEffect")] = effectsManager->activeEffectIndex();
     root[F("logInterval")] = generalSettings.logInterval;
     root[F("working")] = generalSettings.working;
+    root[F("fastBoot")] = generalSettings.fastBoot;
 
     JsonObject matrixObject = root.createNestedObject(F("matrix"));
     matrixObject[F("pin")] = matrixSettings.pin;
+    JsonArray pinsArray = matrixObject.createNestedArray(F("pins"));
+    for (uint8_t pin : matrixSettings.pins) {
+        pinsArray.add(pin);
+    }
     matrixObject[F("width")] = matrixSettings.width;
     matrixObject[F("height")] = matrixSettings.height;
     matrixObject[F("segments")] = matrixSettings.segments;
+    matrixObject[F("tileColumns")] = matrixSettings.tileColumns;
+    JsonArray tileRotationArray = matrixObject.createNestedArray(F("tileRotation"));
+    for (uint8_t rotation : matrixSettings.tileRotation) {
+        tileRotationArray.add(rotation);
+    }
     matrixObject[F("type")] = matrixSettings.type;
     matrixObject[F("maxBrightness")] = matrixSettings.maxBrightness;
     matrixObject[F("currentLimit")] = matrixSettings.currentLimit;
     matrixObject[F("rotation")] = matrixSettings.rotation;
     matrixObject[F("dither")] = matrixSettings.dither;
+    matrixObject[F("ditherRate")] = matrixSettings.ditherRate;
+    matrixObject[F("ditherBackoff")] = matrixSettings.ditherBackoff;
+    matrixObject[F("precision")] = matrixSettings.precision;
     matrixObject[F("order")] = matrixSettings.order;
+    matrixObject[F("driver")] = matrixSettings.driver;
+    matrixObject[F("gamma")] = matrixSettings.gamma;
+    JsonArray whitePointArray = matrixObject.createNestedArray(F("whitePoint"));
+    for (uint8_t level : matrixSettings.whitePoint) {
+        whitePointArray.add(level);
+    }
 
     JsonObject connectionObject = root.createNestedObject(F("connection"));
     connectionObject[F("mdns")] = connectionSettings.mdns;
@@ -686,28 +874,43 @@ void Settings::buildSettingsJson(JsonObject& root)
 
     JsonObject spectrometerObject = root.createNestedObject(F("spectrometer"));
     spectrometerObject[F("active")] = generalSettings.soundControl;
+
+    JsonObject transitionObject = root.createNestedObject(F("transition"));
+    transitionObject[F("mode")] = generalSettings.transitionMode;
+    transitionObject[F("frames")] = generalSettings.transitionFrames;
 }
 
 void Settings::buildEffectsJson(JsonArray& effects)
 {
-    for (Effect* effect : effectsManager->effects) {
+    for (uint8_t index = 0; index < effectsManager->count(); ++index) {
         JsonObject effectObject = effects.createNestedObject();
-        effectObject[F("i")] = effect->settings.id;
-        effectObject[F("n")] = effect->settings.name;
-        effectObject[F("s")] = effect->settings.speed;
-        effectObject[F("l")] = effect->settings.scale;
-        effectObject[F("b")] = effect->settings.brightness;
-        effect->writeSettings(effectObject);
+        buildEffectJson(index, effectObject);
     }
 }
 
+void Settings::buildEffectJson(uint8_t index, JsonObject& effectObject)
+{
+    const Settings::EffectSettings& settings = effectsManager->effectSettings(index);
+    effectObject[F("i")] = settings.id;
+    effectObject[F("n")] = settings.name;
+    effectObject[F("s")] = settings.speed;
+    effectObject[F("l")] = settings.scale;
+    effectObject[F("b")] = settings.brightness;
+    if (settings.fps > 0) {
+        effectObject[F("f")] = settings.fps;
+    }
+    effectsManager->writeEffectSettings(index, effectObject);
+}
+
 void Settings::buildJsonMqtt(JsonObject& root)
 {
+    const uint8_t activeIndex = effectsManager->activeEffectIndex();
+    const Settings::EffectSettings settings = effectsManager->effectSettings(activeIndex);
     root[F("state")] = generalSettings.working ? F("ON") : F("OFF");
-    root[F("brightness")] = effectsManager->activeEffect()->settings.brightness;
-    root[F("speed")] = effectsManager->activeEffect()->settings.speed;
-    root[F("scale")] = effectsManager->activeEffect()->settings.scale;
-    root[F("effect")] = effectsManager->activeEffect()->settings.name;
+    root[F("brightness")] = settings.brightness;
+    root[F("speed")] = settings.speed;
+    root[F("scale")] = settings.scale;
+    root[F("effect")] = settings.name;
     root[F("localIp")] = WiFi.localIP().toString();
     root[F("webui")] = String(F("http://")) + WiFi.localIP().toString();
 #if defined(ESP8266)
@@ -715,7 +918,7 @@ void Settings::buildJsonMqtt(JsonObject& root)
 #else
     root[F("device")] = F("esp32");
 #endif
-    effectsManager->activeEffect()->writeSettings(root);
+    effectsManager->writeEffectSettings(activeIndex, root);
 }
 
 Settings::Settings(uint32_t saveInterval)
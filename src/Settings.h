@@ -1,5 +1,6 @@
 #pragma once
 #include <Arduino.h>
+#include <vector>
 #define ARDUINOJSON_ENABLE_PROGMEM 1
 #include <ArduinoJson.h>
 
@@ -16,6 +17,8 @@ public:
         uint8_t speed = 1;
         uint8_t scale = 100;
         uint8_t brightness = 80;
+        // 0 - frame period follows speed
+        uint8_t fps = 0;
     };
 
     struct GeneralSettings {
@@ -23,6 +26,11 @@ public:
         bool working = true;
         bool soundControl = false;
         uint32_t logInterval = 0;
+        // 0 - cut, 1 - linear crossfade, 2 - gamma-correct crossfade
+        uint8_t transitionMode = 2;
+        uint8_t transitionFrames = 20;
+        // start the saved effect before Wi-Fi and skip the boot delay and matrix test
+        bool fastBoot = true;
     };
 
     struct MatrixSettings {
@@ -33,16 +41,36 @@ public:
 #else
         uint8_t pin = 2;
 #endif
+        // ESP32 only: data pins driven in parallel, the matrix is split into
+        // equal contiguous strips in this order. Overrides pin when set
+        std::vector<uint8_t> pins;
         uint8_t width = 16;
         uint8_t height = 16;
+        // number of equal tiles the matrix is built from
         uint8_t segments = 1;
+        // tiles per row, 0 puts all tiles in one row
+        uint8_t tileColumns = 0;
+        // quarter turns clockwise of each tile, in wiring order
+        std::vector<uint8_t> tileRotation;
         // NEO_MATRIX_BOTTOM + RIGHT + COLUMNS + ZIGZAG
         uint8_t type = 15;
         uint8_t maxBrightness = 80;
         uint16_t currentLimit = 1000;
         uint8_t rotation = 3;
         bool dither = true;
+        // max dither refreshes per second, 0 - as fast as the strip allows
+        uint8_t ditherRate = 50;
+        // ms without dither refreshes after network traffic
+        uint16_t ditherBackoff = 200;
+        // 16 bit brightness and gamma with error carried between frames
+        bool precision = false;
         String order;
+        // ESP8266 only: 0 - bit-bang, 1 - UART1 with interrupts enabled (pin 2)
+        uint8_t driver = 0;
+        // applied to every channel on output, 1.0 leaves colors linear
+        float gamma = 1.0f;
+        // output level of full red, green and blue
+        uint8_t whitePoint[3] = { 255, 255, 255 };
     };
 
     struct ConenctionSettings {
@@ -85,9 +113,12 @@ public:
     void saveLater();
     void saveSettings();
     void saveEffects();
+    // Longest a save kept loop() busy, files are written afterwards
+    uint32_t maxSaveMicros();
 
     void buildSettingsJson(JsonObject &root);
     void buildEffectsJson(JsonArray &effects);
+    void buildEffectJson(uint8_t index, JsonObject &effect);
     void buildJsonMqtt(JsonObject &root);
     void writeEffectsMqtt(JsonArray &array);
 
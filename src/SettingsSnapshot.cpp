@@ -0,0 +1,682 @@
+#include "SettingsSnapshot.h"
+#include "Settings.h"
+#include "EffectsManager.h"
+#include "SettingsWriter.h"
+
+#include <atomic>
+#include <vector>
+
+#if defined(ESP32)
+#include <SPIFFS.h>
+#define FLASHFS SPIFFS
+#else
+#include <LittleFS.h>
+#define FLASHFS LittleFS
+#endif
+
+namespace {
+
+    const char* snapshotFileName PROGMEM = "/settings.bin";
+
+    const uint32_t snapshotMagic = 0x5350414c; // "LAPS"
+    // bump on any change of the records below
+    const uint16_t snapshotVersion = 1;
+
+    struct __attribute__((packed)) SnapshotHeader {
+        uint32_t magic;
+        uint16_t version;
+        // journal records apply to the snapshot of the same generation
+        uint16_t generation;
+        // bytes after the header and their crc32
+        uint32_t size;
+        uint32_t crc;
+    };
+
+    struct __attribute__((packed)) PackedGeneral {
+        uint8_t activeEffect;
+        uint8_t working;
+        uint8_t soundControl;
+        uint32_t logInterval;
+        uint8_t transitionMode;
+        uint8_t transitionFrames;
+        uint8_t fastBoot;
+    };
+
+    // followed by pins, tileRotation and order
+    struct __attribute__((packed)) PackedMatrix {
+        uint8_t pin;
+        uint8_t width;
+        uint8_t height;
+        uint8_t segments;
+        uint8_t tileColumns;
+        uint8_t type;
+        uint8_t maxBrightness;
+        uint16_t currentLimit;
+        uint8_t rotation;
+        uint8_t dither;
+        uint8_t ditherRate;
+        uint16_t ditherBackoff;
+        uint8_t precision;
+        uint8_t driver;
+        float gamma;
+        uint8_t whitePoint[3];
+    };
+
+    struct __attribute__((packed)) PackedButton {
+        uint8_t pin;
+        uint8_t type;
+        uint8_t state;
+    };
+
+    // followed by id, name and effect specific json
+    struct __attribute__((packed)) PackedEffect {
+        uint8_t speed;
+        uint8_t scale;
+        uint8_t brightness;
+        uint8_t fps;
+    };
+
+    const char* journalFileName PROGMEM = "/settings.journal";
+
+    const uint32_t journalMagic = 0x4a50414c; // "LAPJ"
+    // a new snapshot is written once the journal grows past this
+    const size_t journalLimit = 4096;
+
+    struct __attribute__((packed)) JournalHeader {
+        uint32_t magic;
+        uint16_t generation;
+        uint16_t reserved;
+    };
+
+    enum JournalRecordType : uint8_t {
+        JournalGeneral = 1,
+        JournalEffect = 2,
+    };
+
+    // followed by size bytes: PackedGeneral or an effect as in the snapshot
+    struct __attribute__((packed)) JournalRecord {
+        uint8_t type;
+        uint8_t index;
+        uint16_t size;
+        uint32_t crc;
+    };
+
+    uint32_t snapshotCrc(const uint8_t* data, size_t size)
+    {
+        uint32_t crc = 0xffffffff;
+        while (size--) {
+            crc ^= *data++;
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+    struct SnapshotWriter
+    {
+        std::vector<uint8_t> data;
+
+        void put(const void* value, size_t size)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(value);
+            data.insert(data.end(), bytes, bytes + size);
+        }
+
+        void putString(const String& value)
+        {
+            const uint16_t length = value.length();
+            put(&length, sizeof(length));
+            put(value.c_str(), length);
+        }
+
+        void putBytes(const std::vector<uint8_t>& value)
+        {
+            const uint8_t length = value.size();
+            put(&length, sizeof(length));
+            put(value.data(), length);
+        }
+
+        SettingsWriter::Buffer release()
+        {
+            SettingsWriter::Buffer buffer = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+            data = std::vector<uint8_t>();
+            return buffer;
+        }
+    };
+
+    // Reads fields in the order they were put, fails once the data runs out
+    struct SnapshotReader
+    {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+        size_t offset = 0;
+
+        bool get(void* value, size_t length)
+        {
+            if (offset + length > size) {
+                return false;
+            }
+            memcpy(value, data + offset, length);
+            offset += length;
+            return true;
+        }
+
+        bool getString(String& value)
+        {
+            uint16_t length = 0;
+            if (!get(&length, sizeof(length)) || offset + length > size) {
+                return false;
+            }
+            value = String();
+            value.reserve(length);
+            for (uint16_t index = 0; index < length; ++index) {
+                value += static_cast<char>(data[offset + index]);
+            }
+            offset += length;
+            return true;
+        }
+
+        bool getBytes(std::vector<uint8_t>& value)
+        {
+            uint8_t length = 0;
+            if (!get(&length, sizeof(length)) || offset + length > size) {
+                return false;
+            }
+            value.assign(data + offset, data + offset + length);
+            offset += length;
+            return true;
+        }
+
+        void release()
+        {
+            delete[] data;
+            data = nullptr;
+            size = 0;
+            offset = 0;
+        }
+    };
+
+    // effect list waits here between readSettings() and readEffects()
+    SnapshotReader reader;
+
+    uint16_t generation = 0;
+    // changes can be journaled, the snapshot of this generation is on flash
+    bool snapshotValid = false;
+    // an upload replaces the files, see discard()
+    std::atomic<bool> snapshotDiscarded(false);
+    size_t journalSize = 0;
+    // appends after a damaged record would never be replayed
+    bool journalDamaged = false;
+
+    // crc of every record as last written, to journal only what changed
+    uint32_t generalCrc = 0;
+    std::vector<uint32_t> effectCrcs;
+
+    void writeGeneral(SnapshotWriter& writer)
+    {
+        const Settings::GeneralSettings& general = mySettings->generalSettings;
+        PackedGeneral packedGeneral;
+        packedGeneral.activeEffect = effectsManager->activeEffectIndex();
+        packedGeneral.working = general.working;
+        packedGeneral.soundControl = general.soundControl;
+        packedGeneral.logInterval = general.logInterval;
+        packedGeneral.transitionMode = general.transitionMode;
+        packedGeneral.transitionFrames = general.transitionFrames;
+        packedGeneral.fastBoot = general.fastBoot;
+        writer.put(&packedGeneral, sizeof(packedGeneral));
+    }
+
+    void readGeneral(const PackedGeneral& packedGeneral, Settings::GeneralSettings& general)
+    {
+        general.activeEffect = packedGeneral.activeEffect;
+        general.working = packedGeneral.working;
+        general.soundControl = packedGeneral.soundControl;
+        general.logInterval = packedGeneral.logInterval;
+        general.transitionMode = packedGeneral.transitionMode;
+        general.transitionFrames = packedGeneral.transitionFrames;
+        general.fastBoot = packedGeneral.fastBoot;
+    }
+
+    void writeEffect(SnapshotWriter& writer, uint8_t index)
+    {
+        const Settings::EffectSettings& settings = effectsManager->effectSettings(index);
+        PackedEffect packedEffect;
+        packedEffect.speed = settings.speed;
+        packedEffect.scale = settings.scale;
+        packedEffect.brightness = settings.brightness;
+        packedEffect.fps = settings.fps;
+        writer.put(&packedEffect, sizeof(packedEffect));
+        writer.putString(settings.id);
+        writer.putString(settings.name);
+        writer.putString(effectsManager->effectExtra(index));
+    }
+
+    bool readEffect(SnapshotReader& source, Settings::EffectSettings& settings, String& extra)
+    {
+        PackedEffect packedEffect;
+        if (!source.get(&packedEffect, sizeof(packedEffect))
+            || !source.getString(settings.id)
+            || !source.getString(settings.name)
+            || !source.getString(extra)) {
+            return false;
+        }
+        settings.speed = packedEffect.speed;
+        settings.scale = packedEffect.scale;
+        settings.brightness = packedEffect.brightness;
+        settings.fps = packedEffect.fps;
+        return true;
+    }
+
+    void resetChanges()
+    {
+        SnapshotWriter writer;
+        writeGeneral(writer);
+        generalCrc = snapshotCrc(writer.data.data(), writer.data.size());
+
+        effectCrcs.resize(effectsManager->count());
+        for (uint8_t index = 0; index < effectCrcs.size(); ++index) {
+            writer.data.clear();
+            writeEffect(writer, index);
+            effectCrcs[index] = snapshotCrc(writer.data.data(), writer.data.size());
+        }
+    }
+
+    // a failed write leaves nothing to journal against until the next full save
+    void fileWritten(bool written)
+    {
+        if (!written) {
+            snapshotValid = false;
+        }
+    }
+
+    void startJournal()
+    {
+        JournalHeader header;
+        header.magic = journalMagic;
+        header.generation = generation;
+        header.reserved = 0;
+        SnapshotWriter writer;
+        writer.put(&header, sizeof(header));
+        SettingsWriter::replace(journalFileName, writer.release(), fileWritten);
+        journalSize = sizeof(header);
+        journalDamaged = false;
+    }
+
+    // Applies the records written since the snapshot, stops at the first
+    // damaged one, a torn append loses only the last change
+    void replayJournal()
+    {
+        File file = FLASHFS.open(journalFileName, "r");
+        if (!file) {
+            return;
+        }
+        SnapshotReader journal;
+        journal.size = file.size();
+        journal.data = new uint8_t[journal.size];
+        const size_t read = file.read(journal.data, journal.size);
+        file.close();
+
+        JournalHeader header;
+        if (read != journal.size || !journal.get(&header, sizeof(header))
+            || header.magic != journalMagic || header.generation != generation) {
+#ifdef USE_DEBUG
+            Serial.println(F("Settings journal is from another snapshot"));
+#endif
+            journal.release();
+            return;
+        }
+
+        uint16_t records = 0;
+        JournalRecord record;
+        while (journal.get(&record, sizeof(record))) {
+            const size_t start = journal.offset;
+            if (start + record.size > journal.size
+                || record.crc != snapshotCrc(journal.data + start, record.size)) {
+                break;
+            }
+            if (record.type == JournalGeneral) {
+                PackedGeneral packedGeneral;
+                if (journal.get(&packedGeneral, sizeof(packedGeneral))) {
+                    readGeneral(packedGeneral, mySettings->generalSettings);
+                }
+            }
+            else if (record.type == JournalEffect && record.index < effectsManager->count()) {
+                EffectRecord& effect = effectsManager->effects[record.index];
+                Settings::EffectSettings settings;
+                String extra;
+                if (readEffect(journal, settings, extra) && settings.id == effect.settings.id) {
+                    effect.settings = settings;
+                    effect.extra = extra;
+                }
+            }
+            journal.offset = start + record.size;
+            ++records;
+        }
+        journalSize = journal.offset;
+        journalDamaged = journal.offset != journal.size;
+        journal.release();
+#ifdef USE_DEBUG
+        Serial.printf_P(PSTR("Settings journal replayed: %u records\n"), records);
+#endif
+    }
+
+    void appendRecord(SnapshotWriter& journal, SnapshotWriter& record, JournalRecordType type, uint8_t index)
+    {
+        JournalRecord header;
+        header.type = type;
+        header.index = index;
+        header.size = record.data.size();
+        header.crc = snapshotCrc(record.data.data(), record.data.size());
+        journal.put(&header, sizeof(header));
+        journal.put(record.data.data(), record.data.size());
+    }
+
+    bool loadFile()
+    {
+        File file = FLASHFS.open(snapshotFileName, "r");
+        if (!file) {
+            return false;
+        }
+
+        SnapshotHeader header;
+        const size_t fileSize = file.size();
+        if (fileSize < sizeof(header)) {
+            file.close();
+            return false;
+        }
+        uint8_t* data = new uint8_t[fileSize];
+        const size_t read = file.read(data, fileSize);
+        file.close();
+
+        memcpy(&header, data, sizeof(header));
+        if (read != fileSize || header.magic != snapshotMagic || header.version != snapshotVersion
+            || header.size != fileSize - sizeof(header)
+            || header.crc != snapshotCrc(data + sizeof(header), header.size)) {
+#ifdef USE_DEBUG
+            Serial.println(F("Settings snapshot is damaged or outdated"));
+#endif
+            delete[] data;
+            return false;
+        }
+
+        reader.data = data;
+        reader.size = fileSize;
+        reader.offset = sizeof(header);
+        generation = header.generation;
+        return true;
+    }
+
+    bool readRecords(Settings* settings)
+    {
+        PackedGeneral packedGeneral;
+        if (!reader.get(&packedGeneral, sizeof(packedGeneral))) {
+            return false;
+        }
+        readGeneral(packedGeneral, settings->generalSettings);
+
+        Settings::MatrixSettings& matrix = settings->matrixSettings;
+        PackedMatrix packedMatrix;
+        if (!reader.get(&packedMatrix, sizeof(packedMatrix))
+            || !reader.getBytes(matrix.pins)
+            || !reader.getBytes(matrix.tileRotation)
+            || !reader.getString(matrix.order)) {
+            return false;
+        }
+        matrix.pin = packedMatrix.pin;
+        matrix.width = packedMatrix.width;
+        matrix.height = packedMatrix.height;
+        matrix.segments = packedMatrix.segments;
+        matrix.tileColumns = packedMatrix.tileColumns;
+        matrix.type = packedMatrix.type;
+        matrix.maxBrightness = packedMatrix.maxBrightness;
+        matrix.currentLimit = packedMatrix.currentLimit;
+        matrix.rotation = packedMatrix.rotation;
+        matrix.dither = packedMatrix.dither;
+        matrix.ditherRate = packedMatrix.ditherRate;
+        matrix.ditherBackoff = packedMatrix.ditherBackoff;
+        matrix.precision = packedMatrix.precision;
+        matrix.driver = packedMatrix.driver;
+        matrix.gamma = packedMatrix.gamma;
+        memcpy(matrix.whitePoint, packedMatrix.whitePoint, sizeof(matrix.whitePoint));
+
+        Settings::ConenctionSettings& connection = settings->connectionSettings;
+        if (!reader.get(&connection.ntpOffset, sizeof(connection.ntpOffset))
+            || !reader.getString(connection.mdns)
+            || !reader.getString(connection.apName)
+            || !reader.getString(connection.apPassword)
+            || !reader.getString(connection.ntpServer)
+            || !reader.getString(connection.hostname)
+            || !reader.getString(connection.ssid)
+            || !reader.getString(connection.bssid)
+            || !reader.getString(connection.password)
+            || !reader.getString(connection.login)) {
+            return false;
+        }
+
+        Settings::MqttSettings& mqtt = settings->mqttSettings;
+        if (!reader.get(&mqtt.port, sizeof(mqtt.port))
+            || !reader.getString(mqtt.host)
+            || !reader.getString(mqtt.username)
+            || !reader.getString(mqtt.password)
+            || !reader.getString(mqtt.uniqueId)
+            || !reader.getString(mqtt.name)
+            || !reader.getString(mqtt.model)) {
+            return false;
+        }
+
+        PackedButton packedButton;
+        if (!reader.get(&packedButton, sizeof(packedButton))) {
+            return false;
+        }
+        settings->buttonSettings.pin = packedButton.pin;
+        settings->buttonSettings.type = packedButton.type;
+        settings->buttonSettings.state = packedButton.state;
+        return true;
+    }
+
+} // namespace
+
+bool SettingsSnapshot::readSettings(Settings* settings)
+{
+    reader.release();
+    snapshotValid = false;
+    SettingsWriter::recover(snapshotFileName);
+    if (!loadFile()) {
+        return false;
+    }
+    if (!readRecords(settings)) {
+#ifdef USE_DEBUG
+        Serial.println(F("Settings snapshot records are broken"));
+#endif
+        reader.release();
+        return false;
+    }
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Settings snapshot read: %zu bytes\n"), reader.size);
+#endif
+    return true;
+}
+
+bool SettingsSnapshot::readEffects()
+{
+    if (!reader.data) {
+        return false;
+    }
+
+    uint8_t count = 0;
+    bool valid = reader.get(&count, sizeof(count));
+    for (uint8_t index = 0; valid && index < count; ++index) {
+        Settings::EffectSettings settings;
+        String extra;
+        valid = readEffect(reader, settings, extra);
+        if (valid) {
+            effectsManager->addEffect(settings, extra);
+        }
+    }
+    reader.release();
+
+    if (!valid || effectsManager->count() == 0) {
+#ifdef USE_DEBUG
+        Serial.println(F("Settings snapshot effects are broken"));
+#endif
+        effectsManager->effects.clear();
+        return false;
+    }
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Settings snapshot effects: %u\n"), effectsManager->count());
+#endif
+
+    replayJournal();
+    resetChanges();
+    if (journalSize == 0) {
+        startJournal();
+    }
+    snapshotValid = true;
+    return true;
+}
+
+void SettingsSnapshot::save()
+{
+    SnapshotWriter writer;
+    writer.data.reserve(1024 + effectsManager->count() * 64);
+    writer.data.resize(sizeof(SnapshotHeader));
+
+    writeGeneral(writer);
+
+    const Settings::MatrixSettings& matrix = mySettings->matrixSettings;
+    PackedMatrix packedMatrix;
+    packedMatrix.pin = matrix.pin;
+    packedMatrix.width = matrix.width;
+    packedMatrix.height = matrix.height;
+    packedMatrix.segments = matrix.segments;
+    packedMatrix.tileColumns = matrix.tileColumns;
+    packedMatrix.type = matrix.type;
+    packedMatrix.maxBrightness = matrix.maxBrightness;
+    packedMatrix.currentLimit = matrix.currentLimit;
+    packedMatrix.rotation = matrix.rotation;
+    packedMatrix.dither = matrix.dither;
+    packedMatrix.ditherRate = matrix.ditherRate;
+    packedMatrix.ditherBackoff = matrix.ditherBackoff;
+    packedMatrix.precision = matrix.precision;
+    packedMatrix.driver = matrix.driver;
+    packedMatrix.gamma = matrix.gamma;
+    memcpy(packedMatrix.whitePoint, matrix.whitePoint, sizeof(packedMatrix.whitePoint));
+    writer.put(&packedMatrix, sizeof(packedMatrix));
+    writer.putBytes(matrix.pins);
+    writer.putBytes(matrix.tileRotation);
+    writer.putString(matrix.order);
+
+    const Settings::ConenctionSettings& connection = mySettings->connectionSettings;
+    writer.put(&connection.ntpOffset, sizeof(connection.ntpOffset));
+    writer.putString(connection.mdns);
+    writer.putString(connection.apName);
+    writer.putString(connection.apPassword);
+    writer.putString(connection.ntpServer);
+    writer.putString(connection.hostname);
+    writer.putString(connection.ssid);
+    writer.putString(connection.bssid);
+    writer.putString(connection.password);
+    writer.putString(connection.login);
+
+    const Settings::MqttSettings& mqtt = mySettings->mqttSettings;
+    writer.put(&mqtt.port, sizeof(mqtt.port));
+    writer.putString(mqtt.host);
+    writer.putString(mqtt.username);
+    writer.putString(mqtt.password);
+    writer.putString(mqtt.uniqueId);
+    writer.putString(mqtt.name);
+    writer.putString(mqtt.model);
+
+    PackedButton packedButton;
+    packedButton.pin = mySettings->buttonSettings.pin;
+    packedButton.type = mySettings->buttonSettings.type;
+    packedButton.state = mySettings->buttonSettings.state;
+    writer.put(&packedButton, sizeof(packedButton));
+
+    const uint8_t count = effectsManager->count();
+    writer.put(&count, sizeof(count));
+    for (uint8_t index = 0; index < count; ++index) {
+        writeEffect(writer, index);
+    }
+
+    // records journaled for the previous snapshot must not apply to this one
+    ++generation;
+
+    SnapshotHeader header;
+    header.magic = snapshotMagic;
+    header.version = snapshotVersion;
+    header.generation = generation;
+    header.size = writer.data.size() - sizeof(header);
+    header.crc = snapshotCrc(writer.data.data() + sizeof(header), header.size);
+    memcpy(writer.data.data(), &header, sizeof(header));
+
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Settings snapshot queued: %zu bytes\n"), writer.data.size());
+#endif
+    // the writer keeps files in order, the journal is reset after the
+    // snapshot is complete
+    SettingsWriter::replace(snapshotFileName, writer.release(), fileWritten);
+    resetChanges();
+    startJournal();
+    snapshotValid = true;
+}
+
+bool SettingsSnapshot::saveChanges()
+{
+    if (!snapshotValid || effectCrcs.size() != effectsManager->count()) {
+        return false;
+    }
+
+    SnapshotWriter journal;
+    SnapshotWriter record;
+    writeGeneral(record);
+    uint32_t crc = snapshotCrc(record.data.data(), record.data.size());
+    if (crc != generalCrc) {
+        appendRecord(journal, record, JournalGeneral, 0);
+        generalCrc = crc;
+    }
+    for (uint8_t index = 0; index < effectCrcs.size(); ++index) {
+        record.data.clear();
+        writeEffect(record, index);
+        crc = snapshotCrc(record.data.data(), record.data.size());
+        if (crc != effectCrcs[index]) {
+            appendRecord(journal, record, JournalEffect, index);
+            effectCrcs[index] = crc;
+        }
+    }
+    if (journal.data.empty()) {
+        return true;
+    }
+
+    journalSize += journal.data.size();
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Settings journal: %zu bytes queued, %zu total\n"), journal.data.size(), journalSize);
+#endif
+    SettingsWriter::append(journalFileName, journal.release(), fileWritten);
+    return true;
+}
+
+bool SettingsSnapshot::journalFull()
+{
+    return snapshotValid && (journalDamaged || journalSize > journalLimit);
+}
+
+void SettingsSnapshot::discard()
+{
+    snapshotDiscarded = true;
+    SettingsWriter::cancel();
+    reader.release();
+    snapshotValid = false;
+    if (FLASHFS.exists(snapshotFileName)) {
+        FLASHFS.remove(snapshotFileName);
+    }
+    if (FLASHFS.exists(journalFileName)) {
+        FLASHFS.remove(journalFileName);
+    }
+}
+
+bool SettingsSnapshot::discarded()
+{
+    return snapshotDiscarded;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <Arduino.h>
+
+class Settings;
+
+// Binary copy of the settings and the effect list, read at boot with one
+// file read instead of parsing settings.json and effects.json. The json
+// files stay the format for editing and upload, the snapshot is written
+// together with them and dropped when a new one is uploaded.
+// A version and crc32 in the header reject snapshots from other firmware
+// or torn writes, the json files are read then.
+//
+// Changes between full saves are appended to a journal as one record per
+// changed effect or general settings block and replayed over the snapshot
+// at boot.
+class SettingsSnapshot
+{
+public:
+    // Fills settings from the snapshot file, false if there is no valid one
+    static bool readSettings(Settings *settings);
+    // Effect list from the snapshot loaded by readSettings() with the
+    // journal applied, frees the snapshot
+    static bool readEffects();
+
+    // Queues a snapshot of the current state and an empty journal
+    static void save();
+    // Queues records for what changed since the last save, false if there
+    // is no snapshot to journal against and a full save is needed
+    static bool saveChanges();
+    // Journal has grown enough to be compacted into a new snapshot
+    static bool journalFull();
+    // Drops snapshot, journal and queued writes for an uploaded json that
+    // is read at next boot. Nothing is saved until then.
+    static void discard();
+    static bool discarded();
+};
@@ -0,0 +1,336 @@
+#include "SettingsWriter.h"
+
+#include <deque>
+
+#if defined(ESP32)
+#include <SPIFFS.h>
+#define FLASHFS SPIFFS
+#else
+#include <LittleFS.h>
+#define FLASHFS LittleFS
+#endif
+
+namespace {
+
+    // small enough that a chunk costs at most one flash erase
+    const size_t chunkSize = 256;
+
+    struct WriteJob
+    {
+        String fileName;
+        SettingsWriter::Parts parts;
+        SettingsWriter::Callback done = nullptr;
+        bool append = false;
+        bool cancelled = false;
+        uint32_t queuedAt = 0;
+        // position of the next byte to write
+        size_t part = 0;
+        size_t offset = 0;
+        File file;
+    };
+
+    // Producers only push to the back. References to the front job stay
+    // valid while they do, so the writer doesn't hold the lock during writes.
+    std::deque<WriteJob> jobs;
+    // set by cancel(), nothing is written until reboot
+    bool closed = false;
+
+    uint32_t filesCount = 0;
+    uint32_t chunkMicros = 0;
+    uint32_t fileMillis = 0;
+
+#if defined(ESP32)
+    const uint32_t writerTaskStackSize = 4096;
+    const UBaseType_t writerTaskPriority = 1;
+    const BaseType_t writerTaskCore = 0;
+
+    SemaphoreHandle_t jobsMutex = nullptr;
+    TaskHandle_t writerTaskHandle = nullptr;
+#endif
+
+    // the mutex is created with the task on the first queued file
+    void lockJobs()
+    {
+#if defined(ESP32)
+        if (jobsMutex) {
+            xSemaphoreTake(jobsMutex, portMAX_DELAY);
+        }
+#endif
+    }
+
+    void unlockJobs()
+    {
+#if defined(ESP32)
+        if (jobsMutex) {
+            xSemaphoreGive(jobsMutex);
+        }
+#endif
+    }
+
+    String temporaryName(const String& fileName)
+    {
+        return fileName + F(".tmp");
+    }
+
+    bool finishJob(WriteJob& job, bool written)
+    {
+        if (job.file) {
+            job.file.close();
+        }
+        if (job.append) {
+            return written;
+        }
+        const String temporary = temporaryName(job.fileName);
+        // one step with cancel(), whoever cancels can remove the file
+        // right after without it being renamed back into place
+        lockJobs();
+        if (!written || job.cancelled) {
+            FLASHFS.remove(temporary);
+            unlockJobs();
+            return false;
+        }
+#if defined(ESP32)
+        // SPIFFS can't rename over an existing file, recover() finishes
+        // the job if a reset comes in between
+        if (FLASHFS.exists(job.fileName)) {
+            FLASHFS.remove(job.fileName);
+        }
+#endif
+        const bool renamed = FLASHFS.rename(temporary, job.fileName);
+        unlockJobs();
+        return renamed;
+    }
+
+    // Writes the next chunk of the first queued file, false if the queue is empty
+    bool writeStep()
+    {
+        lockJobs();
+        if (jobs.empty()) {
+            unlockJobs();
+            return false;
+        }
+        WriteJob& job = jobs.front();
+        unlockJobs();
+
+        const uint32_t start = micros();
+        bool written = !job.cancelled;
+        if (written && !job.file) {
+            if (job.append) {
+                job.file = FLASHFS.open(job.fileName, "a");
+            }
+            else {
+                job.file = FLASHFS.open(temporaryName(job.fileName), "w");
+            }
+            written = static_cast<bool>(job.file);
+        }
+        size_t remaining = chunkSize;
+        while (written && remaining > 0 && job.part < job.parts.size()) {
+            const SettingsWriter::Buffer& data = job.parts[job.part];
+            const size_t length = min(remaining, data->size() - job.offset);
+            written = job.file.write(data->data() + job.offset, length) == length;
+            job.offset += length;
+            remaining -= length;
+            if (job.offset == data->size()) {
+                ++job.part;
+                job.offset = 0;
+            }
+        }
+
+        const bool finished = !written || job.part == job.parts.size();
+        if (finished) {
+            written = finishJob(job, written);
+        }
+        const uint32_t elapsed = micros() - start;
+        if (elapsed > chunkMicros) {
+            chunkMicros = elapsed;
+        }
+        if (!finished) {
+            return true;
+        }
+
+#ifdef USE_DEBUG
+        if (!written && !job.cancelled) {
+            Serial.printf_P(PSTR("Settings writer failed: %s\n"), job.fileName.c_str());
+        }
+#endif
+        if (written) {
+            ++filesCount;
+            const uint32_t duration = millis() - job.queuedAt;
+            if (duration > fileMillis) {
+                fileMillis = duration;
+            }
+        }
+        if (job.done && !job.cancelled) {
+            job.done(written);
+        }
+
+        lockJobs();
+        jobs.pop_front();
+        unlockJobs();
+        return true;
+    }
+
+#if defined(ESP32)
+    void writerTask(void* parameter)
+    {
+        for (;;) {
+            if (writeStep()) {
+                // flash writes stall both cores, leave room between chunks
+                vTaskDelay(1);
+            }
+            else {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+        }
+    }
+#endif
+
+    void queueJob(const String& fileName, const SettingsWriter::Parts& parts, SettingsWriter::Callback done, bool append)
+    {
+#if defined(ESP32)
+        if (!writerTaskHandle) {
+            jobsMutex = xSemaphoreCreateMutex();
+            xTaskCreatePinnedToCore(writerTask,
+                "settings",
+                writerTaskStackSize,
+                nullptr,
+                writerTaskPriority,
+                &writerTaskHandle,
+                writerTaskCore);
+        }
+#endif
+
+        WriteJob job;
+        job.fileName = fileName;
+        job.parts = parts;
+        job.done = done;
+        job.append = append;
+        job.queuedAt = millis();
+
+        lockJobs();
+        if (closed) {
+            unlockJobs();
+            return;
+        }
+        jobs.push_back(job);
+        unlockJobs();
+
+#if defined(ESP32)
+        xTaskNotifyGive(writerTaskHandle);
+#endif
+    }
+
+} // namespace
+
+void SettingsWriter::replace(const String& fileName, Buffer data, Callback done)
+{
+    queueJob(fileName, Parts(1, data), done, false);
+}
+
+void SettingsWriter::replace(const String& fileName, const Parts& parts, Callback done)
+{
+    queueJob(fileName, parts, done, false);
+}
+
+void SettingsWriter::append(const String& fileName, Buffer data, Callback done)
+{
+    queueJob(fileName, Parts(1, data), done, true);
+}
+
+bool SettingsWriter::copy(const String& fileFrom, const String& fileTo)
+{
+    File source = FLASHFS.open(fileFrom, "r");
+    if (!source) {
+        return false;
+    }
+    std::vector<uint8_t>* data = new std::vector<uint8_t>(source.size());
+    const size_t read = source.read(data->data(), data->size());
+    source.close();
+    Buffer buffer(data);
+    if (read != buffer->size()) {
+        return false;
+    }
+    replace(fileTo, buffer);
+    return true;
+}
+
+void SettingsWriter::cancel()
+{
+    lockJobs();
+    for (WriteJob& job : jobs) {
+        job.cancelled = true;
+    }
+    closed = true;
+    unlockJobs();
+}
+
+void SettingsWriter::recover(const String& fileName)
+{
+    const String temporary = temporaryName(fileName);
+    if (!FLASHFS.exists(temporary)) {
+        return;
+    }
+    // the old file is only removed once the temporary one is complete
+    if (FLASHFS.exists(fileName)) {
+        FLASHFS.remove(temporary);
+        return;
+    }
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("Settings writer recovered: %s\n"), fileName.c_str());
+#endif
+    FLASHFS.rename(temporary, fileName);
+}
+
+void SettingsWriter::loop()
+{
+#if defined(ESP8266)
+    writeStep();
+#endif
+}
+
+bool SettingsWriter::idle()
+{
+    lockJobs();
+    const bool empty = jobs.empty();
+    unlockJobs();
+    return empty;
+}
+
+uint32_t SettingsWriter::filesWritten()
+{
+    return filesCount;
+}
+
+uint32_t SettingsWriter::maxChunkMicros()
+{
+    return chunkMicros;
+}
+
+uint32_t SettingsWriter::maxFileMillis()
+{
+    return fileMillis;
+}
+
+void BufferPrint::reserve(size_t size)
+{
+    data.reserve(size);
+}
+
+size_t BufferPrint::write(uint8_t value)
+{
+    data.push_back(value);
+    return 1;
+}
+
+size_t BufferPrint::write(const uint8_t* buffer, size_t size)
+{
+    data.insert(data.end(), buffer, buffer + size);
+    return size;
+}
+
+SettingsWriter::Buffer BufferPrint::release()
+{
+    SettingsWriter::Buffer buffer = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+    data = std::vector<uint8_t>();
+    return buffer;
+}
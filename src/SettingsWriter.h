@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+// Writes settings files from buffers taken when a save starts, so commands
+// change live state right away and the animation doesn't wait for the
+// whole file. ESP8266 writes one chunk per loop(), ESP32 writes from a low
+// priority task. Replaced files are written under a temporary name and
+// renamed once complete. LittleFS renames over the old file, a reset in
+// the middle leaves it. SPIFFS can't, so the old file is removed first and
+// a reset right then leaves only the temporary one until recover().
+class SettingsWriter
+{
+public:
+    typedef std::shared_ptr<const std::vector<uint8_t>> Buffer;
+    // File content in pieces, so large files don't need one block of heap
+    typedef std::vector<Buffer> Parts;
+    // Called from the writer when a file is done, false if it failed
+    typedef void (*Callback)(bool written);
+
+    // Files are written in the order they are queued
+    static void replace(const String &fileName, Buffer data, Callback done = nullptr);
+    static void replace(const String &fileName, const Parts &parts, Callback done = nullptr);
+    static void append(const String &fileName, Buffer data, Callback done = nullptr);
+    // Reads the source now and queues it as a replacement of the target
+    static bool copy(const String &fileFrom, const String &fileTo);
+    // Drops queued files and refuses new ones until reboot, one being
+    // written is left as it was before
+    static void cancel();
+    // Call at boot before reading fileName, puts a complete temporary file
+    // left by a reset in place or drops an incomplete one. A file written
+    // for the first time can't be told apart, readers check the content.
+    static void recover(const String &fileName);
+
+    // ESP8266: writes the next chunk, nothing to do on ESP32
+    static void loop();
+    static bool idle();
+
+    static uint32_t filesWritten();
+    // Longest a single chunk kept its caller waiting, us
+    static uint32_t maxChunkMicros();
+    // Longest from queuing a file to having it on flash, ms
+    static uint32_t maxFileMillis();
+};
+
+// Print into a buffer that can be handed to SettingsWriter
+class BufferPrint : public Print
+{
+public:
+    // Size known up front, e.g. from measureJson(), saves regrowing
+    void reserve(size_t size);
+    size_t write(uint8_t value) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+
+    SettingsWriter::Buffer release();
+
+private:
+    std::vector<uint8_t> data;
+};
@@ -62,10 +62,7 @@ void TimeClient::loop()
 
 void TimeClient::setInterval(uint32_t timerInterval)
 {
-    if (!ntp) {
-        return;
-    }
-
+    // kept for the client created later when an effect starts before Wi-Fi
     if (timerInterval == 0) {
         interval = defaultInterval;
     }
@@ -129,8 +126,11 @@ TimeClient::TimeClient()
         updateInterval);
     ntp->begin();
 
-    interval = defaultInterval;
-    timer = millis();
+    if (interval == 0) {
+        interval = defaultInterval;
+    }
+    // effects may already show the time, sync on the first loop
+    timer = 0;
 
 #ifdef USE_DEBUG
     Serial.printf_P(
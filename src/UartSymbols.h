@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+
+// WS2812 bits as UART characters for the ESP8266 UART1 led output. Every
+// WS2812 bit is four UART bits at 3.2 Mbaud. UART sends LSB first between
+// a low start and a high stop bit; with TX inverted a 6N1 character is
+// 1 abc def 0 on the wire and carries two WS2812 bits, 1000 for a zero and
+// 1110 for a one.
+
+// Writes the four UART characters for one byte of pixel data
+inline uint8_t* encodeUartSymbols(uint8_t value, uint8_t* out)
+{
+    static const uint8_t symbols[4] = { 0b110111, 0b000111, 0b110100, 0b000100 };
+    out[0] = symbols[(value >> 6) & 3];
+    out[1] = symbols[(value >> 4) & 3];
+    out[2] = symbols[(value >> 2) & 3];
+    out[3] = symbols[value & 3];
+    return out + 4;
+}
@@ -11,9 +11,72 @@ Effect::~Effect()
 
 }
 
-void Effect::Process() {
+void Effect::start()
+{
+    arena = EffectArena::acquire();
+    activate();
+}
+
+void Effect::stop()
+{
+    // stop() without start() has nothing to give back
+    if (!arena) {
+        return;
+    }
+    deactivate();
+    const size_t used = arena->used();
+    if (stats && used > stats->arenaHighWater) {
+        stats->arenaHighWater = used;
+    }
+#ifdef USE_DEBUG
+    Serial.printf_P(PSTR("%s used %u arena bytes\n"), settings.id.c_str(), used);
+#endif
+    arena->release();
+    arena = nullptr;
+}
+
+void Effect::Process(uint32_t dt, uint8_t frames) {
+#ifdef USE_PROFILER
+    const uint32_t tickStart = micros();
+#endif
+    // missed frames are rendered back to back, only the last one is shown
+    const uint32_t frameDt = dt / frames;
+    for (uint8_t frame = 1; frame < frames; ++frame) {
+        tick(frameDt);
+    }
+    tick(dt - frameDt * (frames - 1));
+#ifdef USE_PROFILER
+    const uint32_t showStart = micros();
+    if (stats) {
+        stats->profile.tick.add(showStart - tickStart);
+    }
+#endif
+    // static effects would otherwise resend the same frame every tick
+    myMatrix->showIfChanged();
+#ifdef USE_PROFILER
+    if (stats) {
+        stats->profile.show.add(micros() - showStart);
+    }
+#endif
+}
+
+void Effect::tick(uint32_t dt)
+{
     tick();
-    myMatrix->show();
+}
+
+uint32_t Effect::frameInterval() const
+{
+    if (settings.fps > 0) {
+        return 1000 / settings.fps;
+    }
+    // legacy behaviour: speed slider sets the frame period
+    return 255 - settings.speed;
+}
+
+FrameScheduler::Policy Effect::framePolicy() const
+{
+    return policy;
 }
 
 void Effect::initialize(const JsonObject &json)
@@ -50,6 +113,12 @@ void Effect::update(const JsonObject &json)
     if (json.containsKey(F("scale"))) {
         settings.scale = json[F("scale")];
     }
+    if (json.containsKey(F("f"))) {
+        settings.fps = json[F("f")];
+    }
+    if (json.containsKey(F("fps"))) {
+        settings.fps = json[F("fps")];
+    }
 }
 
 void Effect::writeSettings(JsonObject &json)
@@ -1,15 +1,36 @@
 #pragma once
 #include "MyMatrix.h"
 #include "Settings.h"
+#include "FrameScheduler.h"
+#include "EffectArena.h"
+#ifdef USE_PROFILER
+#include "Profiler.h"
+#endif
 #define ARDUINOJSON_ENABLE_PROGMEM 1
 #include <ArduinoJson.h>
 
+// Statistics kept by EffectsManager for every effect, they outlive the
+// effect instance which only exists while the effect is active
+struct EffectStats
+{
+    // Most arena bytes used by any activation so far
+    size_t arenaHighWater = 0;
+#ifdef USE_PROFILER
+    EffectProfile profile;
+#endif
+};
+
 class Effect
 {
 public:
     Effect(const String &id);
     virtual ~Effect();
-    void Process();
+    void Process(uint32_t dt, uint8_t frames = 1);
+
+    // Called by EffectsManager, hand out the arena around activate() and
+    // drop everything allocated from it after deactivate()
+    void start();
+    void stop();
 
     virtual void activate() {}
     virtual void deactivate() {}
@@ -18,7 +39,19 @@ public:
     virtual void update(const JsonObject &json);
     virtual void writeSettings(JsonObject &json);
 
-    virtual void tick() = 0;
+    // Frame based effects override tick(), time based ones override
+    // tick(dt) and advance by dt milliseconds of real time
+    virtual void tick() {}
+    virtual void tick(uint32_t dt);
+
+    uint32_t frameInterval() const;
+    FrameScheduler::Policy framePolicy() const;
 
     Settings::EffectSettings settings;
+    EffectStats *stats = nullptr;
+
+protected:
+    FrameScheduler::Policy policy = FrameScheduler::PolicySkip;
+    // Valid between activate() and deactivate()
+    EffectArena *arena = nullptr;
 };
@@ -48,7 +48,7 @@ WaveEffect::WaveEffect(const String &id)
 
 void WaveEffect::activate()
 {
-    waveScale = 256 / mySettings->matrixSettings.width;
+    waveScale = min(256 / mySettings->matrixSettings.width, 255);
 
     waveRotation = (settings.scale - 1) / 25;
     waveCount = (255 - settings.speed) % 2;
@@ -1,24 +1,32 @@
 #include "BouncingBallsEffect.h"
+#include "EffectClock.h"
+#include "FixedMath.h"
+
+using namespace FixedMath;
 
 namespace {
 
 bool isColored = false;
 
-float bballsGRAVITY = 9.81f;
-uint8_t bballsH0 = 1;
+// physics runs in q16_16, heights are in units of the drop height
+const q16_16 bballsGRAVITY = toQ16_16(9.81f);
+// sqrt(2 * g * h0), speed at impact when dropped from h0 = 1
+const q16_16 bballsVImpact0 = toQ16_16(4.4294f);
+// coefficients of restitution are q0.16
+const uint16_t bballsCORMax = 58982; // 0.90
+const uint16_t bballsCORShift = 58327; // 0.89
+
 uint8_t bballsMaxNUM = 0;
 uint8_t bballsNUM = 0;
 
-float bballsVImpact0 = 0.0f;
-
 uint8_t* bballsCOLOR = nullptr;
 uint8_t* bballsX = nullptr;
 bool* bballsShift = nullptr;
 
-float* bballsVImpact = nullptr;
+q16_16* bballsVImpact = nullptr;
 int* bballsPos = nullptr;
 long* bballsTLast = nullptr;
-float* bballsCOR = nullptr;
+uint16_t* bballsCOR = nullptr;
 
 }
 
@@ -31,16 +39,15 @@ BouncingBallsEffect::BouncingBallsEffect(const String &id)
 void BouncingBallsEffect::activate()
 {
     bballsMaxNUM = mySettings->matrixSettings.width * 2;
-    bballsVImpact0 = sqrt(2 * bballsGRAVITY * bballsH0);
 
-    bballsCOLOR = new uint8_t[bballsMaxNUM];
-    bballsX = new uint8_t[bballsMaxNUM];
-    bballsShift = new bool[bballsMaxNUM];
+    bballsCOLOR = arena->allocate<uint8_t>(bballsMaxNUM);
+    bballsX = arena->allocate<uint8_t>(bballsMaxNUM);
+    bballsShift = arena->allocate<bool>(bballsMaxNUM);
 
-    bballsVImpact = new float[bballsMaxNUM];
-    bballsPos = new int[bballsMaxNUM];
-    bballsTLast = new long[bballsMaxNUM];
-    bballsCOR = new float[bballsMaxNUM];
+    bballsVImpact = arena->allocate<q16_16>(bballsMaxNUM);
+    bballsPos = arena->allocate<int>(bballsMaxNUM);
+    bballsTLast = arena->allocate<long>(bballsMaxNUM);
+    bballsCOR = arena->allocate<uint16_t>(bballsMaxNUM);
 
     bballsNUM = (settings.scale - 1) / 99.0f * (bballsMaxNUM - 1) + 1;
     if (bballsNUM > bballsMaxNUM) {
@@ -49,50 +56,43 @@ void BouncingBallsEffect::activate()
     for (int i = 0 ; i < bballsNUM ; i++) {
         bballsCOLOR[i] = random8();
         bballsX[i] = random8(0, mySettings->matrixSettings.width);
-        bballsTLast[i] = millis();
+        bballsTLast[i] = EffectClock::now();
         bballsPos[i] = 0;
         bballsVImpact[i] = bballsVImpact0;
-        bballsCOR[i] = 0.90f - float(i) / pow(bballsNUM, 2);
+        bballsCOR[i] = bballsCORMax - (uint32_t(i) << 16) / (bballsNUM * bballsNUM);
         bballsShift[i] = false;
     }
 }
 
-void BouncingBallsEffect::deactivate()
-{
-    delete[] bballsCOLOR;
-    delete[] bballsX;
-    delete[] bballsShift;
-
-    delete[] bballsVImpact;
-    delete[] bballsPos;
-    delete[] bballsTLast;
-    delete[] bballsCOR;
-}
-
 void BouncingBallsEffect::tick()
 {
-    float bballsHi = 0;
-    float bballsTCycle = 0;
     myMatrix->dimAll(settings.speed);
     for (int i = 0 ; i < bballsNUM ; i++) {
         //leds[XY(bballsX[i], bballsPos[i])] = CRGB::Black;
 
-        bballsTCycle =  millis() - bballsTLast[i];
+        const int32_t bballsTCycle = EffectClock::now() - bballsTLast[i];
 
-        bballsHi = -0.5f * bballsGRAVITY * pow(bballsTCycle / 1000.0f , 2.0f) + bballsVImpact[i] * bballsTCycle / 1000.0f;
+        // h = v * t - g * t^2 / 2 with t in ms, ordered to stay in 32 bits.
+        // A full bounce lasts under a second, anything longer has landed.
+        q16_16 bballsHi = -1;
+        if (bballsTCycle < 1500) {
+            bballsHi = bballsVImpact[i] * bballsTCycle / 1000
+                     - (bballsGRAVITY * bballsTCycle / 1000) * bballsTCycle / 2000;
+        }
 
         if ( bballsHi < 0 ) {
-            bballsTLast[i] = millis();
+            bballsTLast[i] = EffectClock::now();
             bballsHi = 0;
-            bballsVImpact[i] = bballsCOR[i] * bballsVImpact[i];
+            bballsVImpact[i] = ((bballsVImpact[i] >> 4) * bballsCOR[i]) >> 12;
 
-            if (bballsVImpact[i] < 0.01f) {
-                bballsCOR[i] = 0.90f - float(random(0, 9)) / pow(random(4, 9), 2);
-                bballsShift[i] = bballsCOR[i] >= 0.89f;
+            if (bballsVImpact[i] < toQ16_16(0.01f)) {
+                const uint8_t divider = random(4, 9);
+                bballsCOR[i] = bballsCORMax - (uint32_t(random(0, 9)) << 16) / (divider * divider);
+                bballsShift[i] = bballsCOR[i] >= bballsCORShift;
                 bballsVImpact[i] = bballsVImpact0;
             }
         }
-        bballsPos[i] = round(bballsHi * (mySettings->matrixSettings.height - 1) / bballsH0);
+        bballsPos[i] = (bballsHi * (mySettings->matrixSettings.height - 1) + 32768) >> 16;
         if (bballsShift[i] && (bballsPos[i] == mySettings->matrixSettings.height - 1)) {
             bballsShift[i] = false;
             if (bballsCOLOR[i] % 2 == 0) {
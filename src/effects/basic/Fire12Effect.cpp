@@ -22,20 +22,12 @@ void Fire12Effect::activate()
     random16_add_entropy(random(256));
     fireBase = mySettings->matrixSettings.height / 6 + 1;
 
-    noise3d = new uint8_t*[mySettings->matrixSettings.width]();
+    noise3d = arena->allocate<uint8_t*>(mySettings->matrixSettings.width);
     for (uint8_t i = 0; i < mySettings->matrixSettings.width; ++i) {
-        noise3d[i] = new uint8_t[mySettings->matrixSettings.height];
+        noise3d[i] = arena->allocate<uint8_t>(mySettings->matrixSettings.height);
     }
 }
 
-void Fire12Effect::deactivate()
-{
-    for (uint8_t i = 0; i < mySettings->matrixSettings.width; i++) {
-        delete[] noise3d[i];
-    }
-    delete[] noise3d;
-}
-
 void Fire12Effect::tick()
 {
     // Loop for each column individually
@@ -1,4 +1,5 @@
 #include "Fire18Effect.h"
+#include "EffectClock.h"
 
 namespace {
 
@@ -24,59 +25,37 @@ Fire18Effect::Fire18Effect(const String &id)
 
 void Fire18Effect::activate()
 {
-    effectX = new uint32_t[numLayers];
-    effectY = new uint32_t[numLayers];
-    effectZ = new uint32_t[numLayers];
-    effectScaleX = new uint32_t[numLayers];
-    effectScaleY = new uint32_t[numLayers];
+    effectX = arena->allocate<uint32_t>(numLayers);
+    effectY = arena->allocate<uint32_t>(numLayers);
+    effectZ = arena->allocate<uint32_t>(numLayers);
+    effectScaleX = arena->allocate<uint32_t>(numLayers);
+    effectScaleY = arena->allocate<uint32_t>(numLayers);
 
-    noise3d = new uint8_t**[numLayers]();
+    noise3d = arena->allocate<uint8_t**>(numLayers);
     for (uint8_t i = 0; i < numLayers; ++i) {
-        noise3d[i] = new uint8_t*[mySettings->matrixSettings.width];
+        noise3d[i] = arena->allocate<uint8_t*>(mySettings->matrixSettings.width);
         for (uint8_t j = 0; j < mySettings->matrixSettings.width; ++j) {
-            noise3d[i][j] = new uint8_t[mySettings->matrixSettings.height];
+            noise3d[i][j] = arena->allocate<uint8_t>(mySettings->matrixSettings.height);
         }
     }
 
-    fire18heat = new uint8_t*[mySettings->matrixSettings.height];
+    fire18heat = arena->allocate<uint8_t*>(mySettings->matrixSettings.height);
     for (uint8_t j = 0; j < mySettings->matrixSettings.height; ++j) {
-        fire18heat[j] = new uint8_t[mySettings->matrixSettings.width];
+        fire18heat[j] = arena->allocate<uint8_t>(mySettings->matrixSettings.width);
     }
 }
 
-void Fire18Effect::deactivate()
-{
-    delete[] effectX;
-    delete[] effectY;
-    delete[] effectZ;
-    delete[] effectScaleX;
-    delete[] effectScaleY;
-
-    for (uint8_t i = 0; i < numLayers; ++i) {
-        for (uint8_t j = 0; j < mySettings->matrixSettings.width; j++) {
-            delete[] noise3d[i][j];
-        }
-        delete[] noise3d[i];
-    }
-    delete[] noise3d;
-
-    for (uint8_t j = 0; j < mySettings->matrixSettings.height; j++) {
-        delete[] fire18heat[j];
-    }
-    delete[] fire18heat;
-}
-
 void Fire18Effect::tick()
 {
-    uint16_t ctrl1 = inoise16(11 * millis(), 0, 0);
-    uint16_t ctrl2 = inoise16(13 * millis(), 100000, 100000);
+    uint16_t ctrl1 = inoise16(11 * EffectClock::now(), 0, 0);
+    uint16_t ctrl2 = inoise16(13 * EffectClock::now(), 100000, 100000);
     uint16_t  ctrl = ((ctrl1 + ctrl2) / 2);
 
     for (int z = 0; z < numLayers; z++) {
         const uint16_t speed = speedArray[z];
         effectX[z] = 3 * ctrl * speed;
-        effectY[z] = 20 * millis() * speed;
-        effectZ[z] = 5 * millis() * speed ;
+        effectY[z] = 20 * EffectClock::now() * speed;
+        effectZ[z] = 5 * EffectClock::now() * speed ;
         effectScaleX[z] = ctrl1 / 2;
         effectScaleY[z] = ctrl2 / 2;
 
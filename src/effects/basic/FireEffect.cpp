@@ -33,7 +33,8 @@ const unsigned char hueMask[8][16] PROGMEM = {
     {0 , 0 , 0 , 1 , 1 , 0 , 0 , 0 , 0 , 0 , 0 , 1 , 1 , 0 , 0 , 0 }
 };
 
-uint8_t matrixValue[8][16] = {};
+// 8 rows of matrix width, the masks repeat every 16 columns
+uint8_t* matrixValue[8] = {};
 
 bool sparkles = true;
 
@@ -46,15 +47,13 @@ FireEffect::FireEffect(const String &id)
 
 void FireEffect::activate()
 {
-    line = new uint8_t[mySettings->matrixSettings.width]();
+    line = arena->allocate<uint8_t>(mySettings->matrixSettings.width);
+    for (uint8_t y = 0; y < 8; y++) {
+        matrixValue[y] = arena->allocate<uint8_t>(mySettings->matrixSettings.width);
+    }
     generateLine();
 }
 
-void FireEffect::deactivate()
-{
-    delete[] line;
-}
-
 void FireEffect::tick()
 {
     if (pcnt >= 100) {
@@ -114,14 +113,14 @@ void FireEffect::drawFrame(uint8_t pcnt)
                 nextv =
                         (((100.0 - pcnt) * matrixValue[y][x]
                           + pcnt * matrixValue[y - 1][x]) / 100.0)
-                        - pgm_read_byte(&(valueMask[y][x]));
+                        - pgm_read_byte(&(valueMask[y][x % 16]));
 
                 uint8_t hue = (mySettings->generalSettings.soundControl && useSpectrometer)
                         ? mySpectrometer->asHue()
                         : settings.scale * 2.55;
 
                 CRGB color = CHSV(
-                        hue + pgm_read_byte(&(hueMask[y][x])), // H
+                        hue + pgm_read_byte(&(hueMask[y][x % 16])), // H
                         255, // S
                         (uint8_t)max(0, nextv) // V
                         );
@@ -151,7 +150,7 @@ void FireEffect::drawFrame(uint8_t pcnt)
                 : settings.scale * 2.55;
 
         CRGB color = CHSV(
-                hue + pgm_read_byte(&(hueMask[0][x])), // H
+                hue + pgm_read_byte(&(hueMask[0][x % 16])), // H
                 255,           // S
                 (uint8_t)(((100.0 - pcnt) * matrixValue[0][x] + pcnt * line[x]) / 100.0) // V
                 );
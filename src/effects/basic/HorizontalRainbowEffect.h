@@ -5,6 +5,6 @@ class HorizontalRainbowEffect : public Effect
 {
 public:
     explicit HorizontalRainbowEffect(const String &id);
-    void tick() override;
+    void tick(uint32_t dt) override;
 };
 
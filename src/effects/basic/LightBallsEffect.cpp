@@ -1,4 +1,5 @@
 #include "LightBallsEffect.h"
+#include "EffectClock.h"
 
 namespace {
 
@@ -34,7 +35,7 @@ void LightBallsEffect::tick()
     uint16_t m = beatsin16( 97, 0, 255); //123
 
     // The color of each point shifts over time, each at a different speed.
-    uint32_t ms = millis() / (settings.scale / 4 + 1);
+    uint32_t ms = EffectClock::now() / (settings.scale / 4 + 1);
     myMatrix->drawPixelXY(highByte(i * paintWidth) + thickness,
                           highByte(j * paintHeight) + thickness,
                           CHSV(ms / 29, 200, 255));
@@ -19,15 +19,15 @@ LightersEffect::LightersEffect(const String &id)
 
 void LightersEffect::activate()
 {
-    lightersPos = new int*[2]();
-    lightersPos[0] = new int[LIGHTERS_AM]();
-    lightersPos[1] = new int[LIGHTERS_AM]();
+    lightersPos = arena->allocate<int*>(2);
+    lightersPos[0] = arena->allocate<int>(LIGHTERS_AM);
+    lightersPos[1] = arena->allocate<int>(LIGHTERS_AM);
 
-    lightersSpeed = new int8_t*[2]();
-    lightersSpeed[0] = new int8_t[LIGHTERS_AM]();
-    lightersSpeed[1] = new int8_t[LIGHTERS_AM]();
+    lightersSpeed = arena->allocate<int8_t*>(2);
+    lightersSpeed[0] = arena->allocate<int8_t>(LIGHTERS_AM);
+    lightersSpeed[1] = arena->allocate<int8_t>(LIGHTERS_AM);
 
-    lightersColor = new CHSV[LIGHTERS_AM]();
+    lightersColor = arena->allocate<CHSV>(LIGHTERS_AM);
 
     for (uint8_t i = 0; i < LIGHTERS_AM; i++) {
         lightersPos[0][i] = random(0, mySettings->matrixSettings.width * 10);
@@ -38,19 +38,6 @@ void LightersEffect::activate()
     }
 }
 
-void LightersEffect::deactivate()
-{
-    delete[] lightersPos[0];
-    delete[] lightersPos[1];
-    delete[] lightersPos;
-
-    delete[] lightersSpeed[0];
-    delete[] lightersSpeed[1];
-    delete[] lightersSpeed;
-
-    delete[] lightersColor;
-}
-
 void LightersEffect::tick()
 {
     myMatrix->clear();
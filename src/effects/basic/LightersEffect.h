@@ -6,7 +6,6 @@ class LightersEffect : public Effect
 public:
     explicit LightersEffect(const String &id);
     void activate() override;
-    void deactivate() override;
     void tick() override;
 
 };
@@ -1,4 +1,8 @@
 #include "MetaBallsEffect.h"
+#include "EffectClock.h"
+#include "FixedMath.h"
+
+using namespace FixedMath;
 
 MetaBallsEffect::MetaBallsEffect(const String &id)
     : Effect(id)
@@ -11,11 +15,11 @@ void MetaBallsEffect::tick()
     float speed = (255 - settings.speed) / 127.0;
 
     // get some 2 random moving points
-    uint8_t x2 = inoise8(millis() * speed, 25355, 685 ) / mySettings->matrixSettings.width;
-    uint8_t y2 = inoise8(millis() * speed, 355, 11685 ) / mySettings->matrixSettings.height;
+    uint8_t x2 = inoise8(EffectClock::now() * speed, 25355, 685 ) / mySettings->matrixSettings.width;
+    uint8_t y2 = inoise8(EffectClock::now() * speed, 355, 11685 ) / mySettings->matrixSettings.height;
 
-    uint8_t x3 = inoise8(millis() * speed, 55355, 6685 ) / mySettings->matrixSettings.width;
-    uint8_t y3 = inoise8(millis() * speed, 25355, 22685 ) / mySettings->matrixSettings.height;
+    uint8_t x3 = inoise8(EffectClock::now() * speed, 55355, 6685 ) / mySettings->matrixSettings.width;
+    uint8_t y3 = inoise8(EffectClock::now() * speed, 25355, 22685 ) / mySettings->matrixSettings.height;
 
     // and one Lissajou function
     uint8_t x1 = beatsin8(23 * speed, 0, 15);
@@ -26,17 +30,15 @@ void MetaBallsEffect::tick()
 
             // calculate distances of the 3 points from actual pixel
             // and add them together with weightening
-            uint8_t  dx =  abs(x - x1);
-            uint8_t  dy =  abs(y - y1);
-            uint8_t dist = 2 * sqrt((dx * dx) + (dy * dy));
-
-            dx =  abs(x - x2);
-            dy =  abs(y - y2);
-            dist += sqrt((dx * dx) + (dy * dy));
-
-            dx =  abs(x - x3);
-            dy =  abs(y - y3);
-            dist += sqrt((dx * dx) + (dy * dy));
+            const q8_8 x0 = x << 8;
+            const q8_8 y0 = y << 8;
+            const uint32_t sum = 2 * hypotQ8_8(x0 - (x1 << 8), y0 - (y1 << 8))
+                               + hypotQ8_8(x0 - (x2 << 8), y0 - (y2 << 8))
+                               + hypotQ8_8(x0 - (x3 << 8), y0 - (y3 << 8));
+            uint8_t dist = sum >> 8;
+            if (dist == 0) {
+                dist = 1;
+            }
 
             // inverse result
             //byte color = modes[currentMode].Speed * 10 / dist;
@@ -62,10 +64,10 @@ void MetaBallsEffect::tick()
                                                                                 0));
                 }
             }
-            // show the 3 points, too
-            myMatrix->drawPixelXY(x1, y1, CHSV(255, 255, 255));
-            myMatrix->drawPixelXY(x2, y2, CHSV(255, 255, 255));
-            myMatrix->drawPixelXY(x3, y3, CHSV(255, 255, 255));
         }
     }
+    // show the 3 points, too
+    myMatrix->drawPixelXY(x1, y1, CHSV(255, 255, 255));
+    myMatrix->drawPixelXY(x2, y2, CHSV(255, 255, 255));
+    myMatrix->drawPixelXY(x3, y3, CHSV(255, 255, 255));
 }
@@ -62,8 +62,8 @@ void MovingCubeEffect::tick()
 
 void MovingCubeEffect::activate()
 {
-    coordB = new int16_t[2]();
-    vectorB = new int8_t[2]();
+    coordB = arena->allocate<int16_t>(2);
+    vectorB = arena->allocate<int8_t>(2);
 
     for (uint8_t i = 0; i < 2; i++) {
         coordB[i] = mySettings->matrixSettings.width / 2 * 10;
@@ -73,12 +73,6 @@ void MovingCubeEffect::activate()
     ballColor = CHSV(random(0, 9) * 28, 255, 255);
 }
 
-void MovingCubeEffect::deactivate()
-{
-    delete[] coordB;
-    delete[] vectorB;
-}
-
 void MovingCubeEffect::initialize(const JsonObject &json)
 {
     Effect::initialize(json);
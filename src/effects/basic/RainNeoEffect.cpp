@@ -192,21 +192,17 @@ RainNeoEffect::RainNeoEffect(const String &id)
 
 void RainNeoEffect::activate()
 {
-    tempMatrix = new uint8_t*[mySettings->matrixSettings.width]();
+    tempMatrix = arena->allocate<uint8_t*>(mySettings->matrixSettings.width);
     for (uint8_t i = 0; i < mySettings->matrixSettings.width; ++i) {
-        tempMatrix[i] = new uint8_t[mySettings->matrixSettings.height];
+        tempMatrix[i] = arena->allocate<uint8_t>(mySettings->matrixSettings.height);
     }
-    splashArray = new uint8_t[mySettings->matrixSettings.width]();
+    splashArray = arena->allocate<uint8_t>(mySettings->matrixSettings.width);
     cloudHeight = mySettings->matrixSettings.height * 0.4 + 1;
 }
 
 void RainNeoEffect::deactivate()
 {
-    for (uint8_t i = 0; i < mySettings->matrixSettings.width; i++) {
-        delete[] tempMatrix[i];
-    }
-    delete[] tempMatrix;
-    delete[] splashArray;
+    // storm and cloud buffers follow the settings while running and stay on the heap
     if (noise) {
         delete[] noise;
         noise = nullptr;
@@ -1,4 +1,19 @@
 #include "SinusoidEffect.h"
+#include "EffectClock.h"
+#include "FixedMath.h"
+
+using namespace FixedMath;
+
+namespace {
+
+// 127 * (1 + sin(sqrt(cx * cx + cy * cy))) for a q8_8 offset from the curve center
+uint8_t wave(q8_8 cx, q8_8 cy)
+{
+    const int32_t s = sinRadians(hypotQ8_8(cx, cy));
+    return ((s + 32767) * 127) >> 15;
+}
+
+} // namespace
 
 SinusoidEffect::SinusoidEffect(const String &id)
     : Effect(id)
@@ -14,26 +29,24 @@ void SinusoidEffect::tick()
     float e_s3_speed = 0.004 * invSpeed + 0.015; // speed of the movement along the Lissajous curves
     float e_s3_size = 3 * (float)settings.scale / 100.0 + 2;    // amplitude of the curves
 
-    float time_shift = float(millis() % (uint32_t)(30000 * (1.0 / ((float)invSpeed / 255))));
+    float time_shift = float(EffectClock::now() % (uint32_t)(30000 * (1.0 / ((float)invSpeed / 255))));
+
+    // curve centers move once per frame, pixels only need integer math
+    const q8_8 redCx = toQ8_8(e_s3_size * sinf(e_s3_speed * 0.003 * time_shift)) - (semiHeightMajor << 8);
+    const q8_8 redCy = toQ8_8(e_s3_size * cosf(e_s3_speed * 0.0022 * time_shift)) - (semiWidthMajor << 8);
+    const q8_8 blueCx = toQ8_8(e_s3_size * sinf(e_s3_speed * 0.0021 * time_shift)) - (semiWidthMajor << 8);
+    const q8_8 blueCy = toQ8_8(e_s3_size * cosf(e_s3_speed * 0.002 * time_shift)) - (semiHeightMajor << 8);
+    const q8_8 greenCx = toQ8_8(e_s3_size * sinf(e_s3_speed * 0.0041 * time_shift)) - (semiWidthMajor << 8);
+    const q8_8 greenCy = toQ8_8(e_s3_size * cosf(e_s3_speed * 0.0052 * time_shift)) - (semiHeightMajor << 8);
 
     for (uint8_t y = 0; y < mySettings->matrixSettings.height; y++) {
         for (uint8_t x = 0; x < mySettings->matrixSettings.width; x++) {
+            const q8_8 fx = x << 8;
+            const q8_8 fy = y << 8;
             CRGB color;
-
-            float cx = y + float(e_s3_size * (sinf (float(e_s3_speed * 0.003 * time_shift)))) - semiHeightMajor;  // the 8 centers the middle on a 16x16
-            float cy = x + float(e_s3_size * (cosf (float(e_s3_speed * 0.0022 * time_shift)))) - semiWidthMajor;
-            float v = 127 * (1 + sinf ( sqrtf ( ((cx * cx) + (cy * cy)) ) ));
-            color.r = v;
-
-            cx = x + float(e_s3_size * (sinf (e_s3_speed * float(0.0021 * time_shift)))) - semiWidthMajor;
-            cy = y + float(e_s3_size * (cosf (e_s3_speed * float(0.002 * time_shift)))) - semiHeightMajor;
-            v = 127 * (1 + sinf ( sqrtf ( ((cx * cx) + (cy * cy)) ) ));
-            color.b = v;
-
-            cx = x + float(e_s3_size * (sinf (e_s3_speed * float(0.0041 * time_shift)))) - semiWidthMajor;
-            cy = y + float(e_s3_size * (cosf (e_s3_speed * float(0.0052 * time_shift)))) - semiHeightMajor;
-            v = 127 * (1 + sinf ( sqrtf ( ((cx * cx) + (cy * cy)) ) ));
-            color.g = v;
+            color.r = wave(fy + redCx, fx + redCy);
+            color.b = wave(fx + blueCx, fy + blueCy);
+            color.g = wave(fx + greenCx, fy + greenCy);
             myMatrix->drawPixelXY(x, y, color);
         }
     }
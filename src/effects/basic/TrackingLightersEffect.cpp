@@ -20,15 +20,15 @@ TrackingLightersEffect::TrackingLightersEffect(const String &id)
 
 void TrackingLightersEffect::activate()
 {
-    lightersPos = new int16_t*[2]();
-    lightersPos[0] = new int16_t[amount]();
-    lightersPos[1] = new int16_t[amount]();
+    lightersPos = arena->allocate<int16_t*>(2);
+    lightersPos[0] = arena->allocate<int16_t>(amount);
+    lightersPos[1] = arena->allocate<int16_t>(amount);
 
-    lightersSpeed = new int8_t*[2]();
-    lightersSpeed[0] = new int8_t[amount]();
-    lightersSpeed[1] = new int8_t[amount]();
+    lightersSpeed = arena->allocate<int8_t*>(2);
+    lightersSpeed[0] = arena->allocate<int8_t>(amount);
+    lightersSpeed[1] = arena->allocate<int8_t>(amount);
 
-    lightersColor = new CHSV[amount]();
+    lightersColor = arena->allocate<CHSV>(amount);
 
     for (uint8_t j = 0; j < amount; j++) {
         int8_t sign = 0;
@@ -42,19 +42,6 @@ void TrackingLightersEffect::activate()
     }
 }
 
-void TrackingLightersEffect::deactivate()
-{
-    delete[] lightersPos[0];
-    delete[] lightersPos[1];
-    delete[] lightersPos;
-
-    delete[] lightersSpeed[0];
-    delete[] lightersSpeed[1];
-    delete[] lightersSpeed;
-
-    delete[] lightersColor;
-}
-
 void TrackingLightersEffect::tick()
 {
     if (tails) {
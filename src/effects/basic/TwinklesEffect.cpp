@@ -20,7 +20,7 @@ TwinklesEffect::TwinklesEffect(const String &id)
 void TwinklesEffect::activate()
 {
     hue = 0;
-    ledsbuff = new CRGB[myMatrix->getNumLeds()];
+    ledsbuff = arena->allocate<CRGB>(myMatrix->getNumLeds());
     for (uint32_t idx=0; idx < myMatrix->getNumLeds(); idx++) {
         if (random8(settings.scale % 11) == 0) {
             ledsbuff[idx].r = random8();
@@ -32,11 +32,6 @@ void TwinklesEffect::activate()
     }
 }
 
-void TwinklesEffect::deactivate()
-{
-    delete[] ledsbuff;
-}
-
 void TwinklesEffect::tick()
 {
     for (uint16_t idx=0; idx < myMatrix->getNumLeds(); idx++) {
@@ -2,20 +2,23 @@
 
 namespace  {
 
-uint8_t hue = 0;
+// 8.8 fixed point, so slow speeds still advance at high frame rates
+uint16_t hue = 0;
 
 } // namespace
 
 VerticalRainbowEffect::VerticalRainbowEffect(const String &id)
     : Effect(id)
 {
+    settings.fps = 50;
 }
 
-void VerticalRainbowEffect::tick()
+void VerticalRainbowEffect::tick(uint32_t dt)
 {
-    hue += 2;
+    // hue used to move by 2 every (255 - speed) ms frame
+    hue += 512 * dt / (256 - settings.speed);
     for (uint8_t j = 0; j < mySettings->matrixSettings.height; j++) {
-        const CHSV thisColor = CHSV((hue + j * settings.scale), 255, 255);
+        const CHSV thisColor = CHSV(((hue >> 8) + j * settings.scale), 255, 255);
         for (uint8_t i = 0; i < mySettings->matrixSettings.width; i++) {
             myMatrix->drawPixelXY(i, j, thisColor);
         }
@@ -5,6 +5,6 @@ class VerticalRainbowEffect : public Effect
 {
 public:
     explicit VerticalRainbowEffect(const String &id);
-    void tick() override;
+    void tick(uint32_t dt) override;
 };
 
@@ -25,20 +25,12 @@ WaterfallEffect::WaterfallEffect(const String &id)
 
 void WaterfallEffect::activate()
 {
-    noise3d = new uint8_t*[mySettings->matrixSettings.width]();
+    noise3d = arena->allocate<uint8_t*>(mySettings->matrixSettings.width);
     for (uint8_t i = 0; i < mySettings->matrixSettings.width; ++i) {
-        noise3d[i] = new uint8_t[mySettings->matrixSettings.height];
+        noise3d[i] = arena->allocate<uint8_t>(mySettings->matrixSettings.height);
     }
 }
 
-void WaterfallEffect::deactivate()
-{
-    for (uint8_t i = 0; i < mySettings->matrixSettings.width; i++) {
-        delete[] noise3d[i];
-    }
-    delete[] noise3d;
-}
-
 void WaterfallEffect::tick()
 {
     for (uint8_t x = 0; x < mySettings->matrixSettings.width; x++) {
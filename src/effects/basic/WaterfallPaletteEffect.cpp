@@ -100,20 +100,12 @@ void WaterfallPaletteEffect::tick()
 
 void WaterfallPaletteEffect::activate()
 {
-    noise3d = new uint8_t*[mySettings->matrixSettings.width]();
+    noise3d = arena->allocate<uint8_t*>(mySettings->matrixSettings.width);
     for (uint8_t i = 0; i < mySettings->matrixSettings.width; ++i) {
-        noise3d[i] = new uint8_t[mySettings->matrixSettings.height];
+        noise3d[i] = arena->allocate<uint8_t>(mySettings->matrixSettings.height);
     }
 }
 
-void WaterfallPaletteEffect::deactivate()
-{
-    for (uint8_t i = 0; i < mySettings->matrixSettings.width; i++) {
-        delete[] noise3d[i];
-    }
-    delete[] noise3d;
-}
-
 void WaterfallPaletteEffect::initialize(const JsonObject &json)
 {
     Effect::initialize(json);
@@ -1,4 +1,5 @@
 #include "DoubleCometsEffect.h"
+#include "EffectClock.h"
 
 DoubleCometsEffect::DoubleCometsEffect(const String &id)
     : FractionalEffect(id)
@@ -12,13 +13,13 @@ void DoubleCometsEffect::tick()
     myMatrix->dimAll(255 - settings.scale * 2);
 
     // gelb im Kreis
-    byte xx = 2 + sin8( millis() / 10) / 22;
-    byte yy = 2 + cos8( millis() / 10) / 22;
+    byte xx = 2 + sin8( EffectClock::now() / 10) / 22;
+    byte yy = 2 + cos8( EffectClock::now() / 10) / 22;
     myMatrix->drawPixelXY(xx, yy, CRGB(0xFFFF00));
 
     // rot in einer Acht
-    xx = 4 + sin8( millis() / 46) / 32;
-    yy = 4 + cos8( millis() / 15) / 32;
+    xx = 4 + sin8( EffectClock::now() / 46) / 32;
+    yy = 4 + cos8( EffectClock::now() / 15) / 32;
     myMatrix->drawPixelXY(xx, yy, CRGB(0xFF0000));
 
     // Noise
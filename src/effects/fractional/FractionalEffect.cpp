@@ -9,21 +9,21 @@ FractionalEffect::FractionalEffect(const String &id, uint8_t layers)
 
 void FractionalEffect::activate()
 {
-    effectX = new uint32_t[numLayers];
-    effectY = new uint32_t[numLayers];
-    effectZ = new uint32_t[numLayers];
-    effectScaleX = new uint32_t[numLayers];
-    effectScaleY = new uint32_t[numLayers];
+    effectX = arena->allocate<uint32_t>(numLayers);
+    effectY = arena->allocate<uint32_t>(numLayers);
+    effectZ = arena->allocate<uint32_t>(numLayers);
+    effectScaleX = arena->allocate<uint32_t>(numLayers);
+    effectScaleY = arena->allocate<uint32_t>(numLayers);
 
-    noise3d = new uint8_t**[numLayers]();
+    noise3d = arena->allocate<uint8_t**>(numLayers);
     for (uint8_t i = 0; i < numLayers; ++i) {
-        noise3d[i] = new uint8_t*[mySettings->matrixSettings.width];
+        noise3d[i] = arena->allocate<uint8_t*>(mySettings->matrixSettings.width);
         for (uint8_t j = 0; j < mySettings->matrixSettings.width; ++j) {
-            noise3d[i][j] = new uint8_t[mySettings->matrixSettings.height];
+            noise3d[i][j] = arena->allocate<uint8_t>(mySettings->matrixSettings.height);
         }
     }
 
-    ledsbuff = new CRGB[myMatrix->getNumLeds()];
+    ledsbuff = arena->allocate<CRGB>(myMatrix->getNumLeds());
     uint8_t matrixRotation = mySettings->matrixSettings.rotation;
     int invertedRotation = matrixRotation - 2;
     if (invertedRotation < 0) {
@@ -34,21 +34,6 @@ void FractionalEffect::activate()
 
 void FractionalEffect::deactivate()
 {
-    delete[] effectX;
-    delete[] effectY;
-    delete[] effectZ;
-    delete[] effectScaleX;
-    delete[] effectScaleY;
-
-    for (uint8_t i = 0; i < numLayers; ++i) {
-        for (uint8_t j = 0; j < mySettings->matrixSettings.width; j++) {
-            delete[] noise3d[i][j];
-        }
-        delete[] noise3d[i];
-    }
-    delete[] noise3d;
-
-    delete[] ledsbuff;
     myMatrix->setRotation(mySettings->matrixSettings.rotation);
 }
 
@@ -1,4 +1,5 @@
 #include "PulsingCometEffect.h"
+#include "EffectClock.h"
 
 PulsingCometEffect::PulsingCometEffect(const String &id)
     : FractionalEffect(id)
@@ -11,7 +12,7 @@ void PulsingCometEffect::tick()
     //myMatrix->dimAll(184);
     myMatrix->dimAll(255 - settings.scale * 2);
 
-    CRGB _eNs_color = CHSV(millis(), 255, 255);
+    CRGB _eNs_color = CHSV(EffectClock::now(), 255, 255);
     myMatrix->drawPixelXY(myMatrix->getCenterX(), myMatrix->getCenterY(), _eNs_color);
     // Noise
     effectX[0] += 2000;
@@ -1,4 +1,5 @@
 #include "RainbowCometEffect.h"
+#include "EffectClock.h"
 
 RainbowCometEffect::RainbowCometEffect(const String &id)
     : FractionalEffect(id)
@@ -9,7 +10,7 @@ RainbowCometEffect::RainbowCometEffect(const String &id)
 void RainbowCometEffect::tick()
 {
     myMatrix->dimAll(254); // < -- затухание эффекта для последующего кадра
-    CRGB _eNs_color = CHSV(millis() / settings.scale * 2, 255, 255);
+    CRGB _eNs_color = CHSV(EffectClock::now() / settings.scale * 2, 255, 255);
     myMatrix->drawPixelXY(myMatrix->getCenterX(), myMatrix->getCenterY(), _eNs_color);
     myMatrix->drawPixelXY(myMatrix->getCenterX() + 1, myMatrix->getCenterY(), _eNs_color);
     myMatrix->drawPixelXY(myMatrix->getCenterX(), myMatrix->getCenterY() + 1, _eNs_color);
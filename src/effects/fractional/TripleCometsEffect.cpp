@@ -1,4 +1,5 @@
 #include "TripleCometsEffect.h"
+#include "EffectClock.h"
 
 TripleCometsEffect::TripleCometsEffect(const String &id)
     : FractionalEffect(id)
@@ -11,12 +12,12 @@ void TripleCometsEffect::tick()
     //myMatrix->dimAll(220);
     myMatrix->dimAll(255 - settings.scale * 2);
 
-    byte xx = 2 + sin8(millis() / 10) / 22;
-    byte yy = 2 + cos8(millis() / 9) / 22;
+    byte xx = 2 + sin8(EffectClock::now() / 10) / 22;
+    byte yy = 2 + cos8(EffectClock::now() / 9) / 22;
     myMatrix->drawPixelXY(xx, yy, CRGB(0x0000FF));
 
-    xx = 4 + sin8(millis() / 10) / 32;
-    yy = 4 + cos8(millis() / 7) / 32;
+    xx = 4 + sin8(EffectClock::now() / 10) / 32;
+    yy = 4 + cos8(EffectClock::now() / 7) / 32;
     myMatrix->drawPixelXY(xx, yy, CRGB(0xFF0000));
     myMatrix->drawPixelXY(myMatrix->getCenterX(), myMatrix->getCenterY(), CRGB(0xFFFF00));
 
@@ -15,21 +15,13 @@ NoiseEffect::NoiseEffect(const String &id)
 void NoiseEffect::activate()
 {
     maxDimension = max(mySettings->matrixSettings.width, mySettings->matrixSettings.height);
-    noise = new uint8_t*[maxDimension]();
+    noise = arena->allocate<uint8_t*>(maxDimension);
     for (uint8_t i = 0; i < maxDimension; ++i) {
-        noise[i] = new uint8_t[maxDimension];
+        noise[i] = arena->allocate<uint8_t>(maxDimension);
     }
     colorLoop = 0;
 }
 
-void NoiseEffect::deactivate()
-{
-    for (uint8_t i = 0; i < maxDimension; i++) {
-        delete[] noise[i];
-    }
-    delete[] noise;
-}
-
 void NoiseEffect::tick()
 {
     invSpeed = 255 - settings.speed;
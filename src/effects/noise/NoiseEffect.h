@@ -6,7 +6,6 @@ class NoiseEffect : public Effect
 public:
     explicit NoiseEffect(const String &id);
     void activate() override;
-    void deactivate() override;
     virtual void tick() override;
 
 protected:
@@ -15,8 +15,10 @@
 
 #include "LocalDNS.h"
 #include "MyMatrix.h"
+#include "LedOutputStats.h"
 #include "EffectsManager.h"
 #include "Settings.h"
+#include "SettingsWriter.h"
 #include "TimeClient.h"
 
 #include "GyverButton.h"
@@ -54,6 +56,16 @@ namespace {
 
     bool setupMode = false;
     bool connectFinished = false;
+    bool effectStarted = false;
+
+    // Time since power on for each step of setup, time to first light is
+    // the "effect" line
+    void bootPhase(PGM_P phase)
+    {
+#ifdef USE_DEBUG
+        Serial.printf_P(PSTR("Boot %s: %lu ms\n"), phase, millis());
+#endif
+    }
 
     void processMatrix()
     {
@@ -64,6 +76,30 @@ namespace {
             myMatrix->clear(true);
         }
     }
+
+#if defined(ESP32)
+    // Runs in the render task pinned to its own core, so web server,
+    // mDNS, NTP and settings work in the service task no longer stall
+    // animation
+    void renderMatrix()
+    {
+        if (lampWebServer->isUpdating()) {
+            return;
+        }
+        processMatrix();
+    }
+#endif
+
+    void startEffect()
+    {
+        effectsManager->activateEffect(mySettings->generalSettings.activeEffect, false);
+#if defined(ESP32)
+        effectsManager->startRenderTask(renderMatrix);
+#endif
+        effectStarted = true;
+        bootPhase(PSTR("effect"));
+    }
+
 #ifdef USE_DEBUG
     void printFlashInfo()
     {
@@ -110,6 +146,19 @@ namespace {
         Serial.print(++s_counter);
         Serial.print(F("_FreeHeap: "));
         Serial.println(ESP.getFreeHeap());
+        if (effectsManager) {
+            const FrameScheduler& scheduler = effectsManager->frameScheduler();
+            Serial.printf_P(PSTR("Frames: %u, deadline misses: %u, skipped: %u\n"),
+                scheduler.frames(), scheduler.deadlineMisses(), scheduler.skippedFrames());
+        }
+        Serial.printf_P(PSTR("Led output frames: %u, retries: %u, aborts: %u\n"),
+            ledOutputStats.frames, ledOutputStats.retries, ledOutputStats.aborts);
+        Serial.printf_P(PSTR("Shown frames: %u, dither refreshes: %u, backoffs: %u, current: %u mA\n"),
+            MyMatrix::shownFrames(), MyMatrix::ditherRefreshes(), MyMatrix::ditherBackoffs(),
+            MyMatrix::frameMilliamps());
+        Serial.printf_P(PSTR("Settings save: %u us, chunk: %u us, file: %u ms, files: %u\n"),
+            mySettings->maxSaveMicros(), SettingsWriter::maxChunkMicros(), SettingsWriter::maxFileMillis(),
+            SettingsWriter::filesWritten());
         //    Serial.flush();
     }
 #endif
@@ -153,7 +202,7 @@ namespace {
             Serial.println(F("Holded button"));
 #endif
             isHolding = true;
-            const uint8_t brightness = effectsManager->activeEffect()->settings.brightness;
+            const uint8_t brightness = effectsManager->activeBrightness();
             if (brightness <= 1) {
                 stepDirection = 1;
             }
@@ -169,7 +218,7 @@ namespace {
             }
         }
         if (isHolding && button->isStep()) {
-            uint8_t brightness = effectsManager->activeEffect()->settings.brightness;
+            uint8_t brightness = effectsManager->activeBrightness();
             if (stepDirection < 0 && brightness == 1) {
                 return;
             }
@@ -180,8 +229,7 @@ namespace {
 #ifdef USE_DEBUG
             Serial.printf_P(PSTR("Step button %d. brightness: %u\n"), stepDirection, brightness);
 #endif
-            effectsManager->activeEffect()->settings.brightness = brightness;
-            myMatrix->setBrightness(brightness);
+            effectsManager->setActiveBrightness(brightness);
             mySettings->saveLater();
             if (mqtt) {
                 mqtt->update();
@@ -207,6 +255,73 @@ namespace {
     }
 #endif
 
+    // Network, button and settings work, everything but the animation on ESP32
+    void serviceLoop()
+    {
+        if (mySettings->generalSettings.logInterval > 0 && millis() - logTimer > mySettings->generalSettings.logInterval) {
+#ifdef USE_DEBUG
+            printFreeHeap();
+#endif
+            logTimer = millis();
+        }
+
+        lampWebServer->loop();
+
+        // with fast boot the effect runs while Wi-Fi is still connecting
+        if (!connectFinished && !effectStarted) {
+            return;
+        }
+
+        if (lampWebServer->isUpdating()) {
+            return;
+        }
+
+        if (connectFinished) {
+            localDNS->loop();
+        }
+
+        if (setupMode) {
+            return;
+        }
+
+        if (lampWebServer->isConnected()) {
+            timeClient->loop();
+        }
+#if defined(ESP32)
+        effectsManager->processNotifications();
+#endif
+        processButton();
+#if defined(SONOFF)
+        digitalWrite(relayPin, mySettings->generalSettings.working);
+        digitalWrite(miniLedPin, mySettings->generalSettings.working);
+#endif
+
+        //    if (mySettings->generalSettings.soundControl) {
+        //        mySpectrometer->loop();
+        //    }
+
+#if defined(ESP8266)
+        processMatrix();
+#endif
+        mySettings->loop();
+    }
+
+#if defined(ESP32)
+    // loop() runs on core 1 next to the render task, so the service work
+    // moves to a task on core 0 where Wi-Fi runs
+    const uint32_t serviceTaskStackSize = 8192;
+    const UBaseType_t serviceTaskPriority = 1;
+    const BaseType_t serviceTaskCore = 0;
+
+    void serviceTask(void* parameter)
+    {
+        for (;;) {
+            serviceLoop();
+            vTaskDelay(1);
+        }
+    }
+#endif
+
 }
 
 void clearWifi()
@@ -227,12 +342,8 @@ void setup() {
     ESP.wdtEnable(0);
 #endif
 
-    delay(5000);
-
 #ifdef USE_DEBUG
     setupSerial();
-    printFlashInfo();
-    printFreeHeap();
 #endif
 
     if (!FLASHFS.begin()) {
@@ -241,6 +352,7 @@ void setup() {
 #endif
         return;
     }
+    bootPhase(PSTR("filesystem"));
 
     Settings::Initialize();
     // default values for button
@@ -250,14 +362,23 @@ void setup() {
     if (!mySettings->readSettings()) {
         mySettings->buttonSettings.pin = 255;
     }
+    bootPhase(PSTR("settings"));
+
+    if (!mySettings->generalSettings.fastBoot) {
+        delay(5000);
+    }
 
 #ifdef USE_DEBUG
+    printFlashInfo();
+    printFreeHeap();
     Serial.printf_P(PSTR("Button pin: %d\n"), mySettings->buttonSettings.pin);
 #endif
 
     EffectsManager::Initialize();
     mySettings->readEffects();
+    bootPhase(PSTR("effects"));
     MyMatrix::Initialize();
+    bootPhase(PSTR("matrix"));
 
 #if defined(SONOFF)
     pinMode(relayPin, OUTPUT);
@@ -270,7 +391,7 @@ void setup() {
     button->setTickMode(false);
     button->setStepTimeout(20);
 
-    if (mySettings->generalSettings.working) {
+    if (mySettings->generalSettings.working && !mySettings->generalSettings.fastBoot) {
         myMatrix->matrixTest();
     }
 
@@ -290,6 +411,9 @@ void setup() {
     if (setupMode) {
         lampWebServer->enterSetupMode();
     }
+    else if (mySettings->generalSettings.fastBoot) {
+        startEffect();
+    }
 
 #ifdef USE_DEBUG
     Serial.println(F("AutoConnect started"));
@@ -298,9 +422,7 @@ void setup() {
         if (connectFinished) {
             return;
         }
-#ifdef USE_DEBUG
-        Serial.println(F("AutoConnect finished"));
-#endif
+        bootPhase(PSTR("connected"));
         if (isConnected) {
             LocalDNS::Initialize();
             if (localDNS->begin()) {
@@ -320,55 +442,30 @@ void setup() {
         //    if (mySettings->generalSettings.soundControl) {
         //        Spectrometer::Initialize();
         //    }
-        if (!setupMode) {
-            effectsManager->activateEffect(mySettings->generalSettings.activeEffect, false);
+        if (!setupMode && !effectStarted) {
+            startEffect();
         }
         connectFinished = true;
         });
     lampWebServer->autoConnect();
+
+#if defined(ESP32)
+    xTaskCreatePinnedToCore(serviceTask,
+        "service",
+        serviceTaskStackSize,
+        nullptr,
+        serviceTaskPriority,
+        nullptr,
+        serviceTaskCore);
+#endif
 }
 
 void loop() {
-#if defined(ESP8266)
+#if defined(ESP32)
+    // everything runs in the service and render tasks
+    vTaskDelete(nullptr);
+#else
     ESP.wdtFeed();
+    serviceLoop();
 #endif
-
-    if (mySettings->generalSettings.logInterval > 0 && millis() - logTimer > mySettings->generalSettings.logInterval) {
-#ifdef USE_DEBUG
-        printFreeHeap();
-#endif
-        logTimer = millis();
-    }
-
-    lampWebServer->loop();
-
-    if (!connectFinished) {
-        return;
-    }
-
-    if (lampWebServer->isUpdating()) {
-        return;
-    }
-
-    localDNS->loop();
-
-    if (setupMode) {
-        return;
-    }
-
-    if (lampWebServer->isConnected()) {
-        timeClient->loop();
-    }
-    processButton();
-#if defined(SONOFF)
-    digitalWrite(relayPin, mySettings->generalSettings.working);
-    digitalWrite(miniLedPin, mySettings->generalSettings.working);
-#endif
-
-    //    if (mySettings->generalSettings.soundControl) {
-    //        mySpectrometer->loop();
-    //    }
-
-    processMatrix();
-    mySettings->loop();
 }
@@ -0,0 +1,174 @@
+// FixedMath against the float math it replaces in Sinusoid, MetaBalls and
+// BouncingBalls, plus a per-frame cost comparison of both.
+// Run with `platformio test -e native -v` to see the benchmark numbers.
+#include <unity.h>
+
+#include "FixedMath.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+using namespace FixedMath;
+
+namespace {
+
+    // Sinusoid draws 127 * (1 + sin(hypot(cx, cy))) per pixel and channel
+    uint8_t waveFloat(float cx, float cy)
+    {
+        return 127 * (1 + sinf(sqrtf(cx * cx + cy * cy)));
+    }
+
+    uint8_t waveFixed(q8_8 cx, q8_8 cy)
+    {
+        const int32_t s = sinRadians(hypotQ8_8(cx, cy));
+        return ((s + 32767) * 127) >> 15;
+    }
+
+    // sum of MetaBalls' three distances, for 16x16 frames
+    uint8_t metaBallsFloat(uint8_t x, uint8_t y)
+    {
+        uint8_t dx = abs(x - 3);
+        uint8_t dy = abs(y - 12);
+        uint8_t dist = 2 * sqrt((dx * dx) + (dy * dy));
+        dx = abs(x - 9);
+        dy = abs(y - 4);
+        dist += sqrt((dx * dx) + (dy * dy));
+        dx = abs(x - 14);
+        dy = abs(y - 7);
+        dist += sqrt((dx * dx) + (dy * dy));
+        return dist;
+    }
+
+    uint8_t metaBallsFixed(uint8_t x, uint8_t y)
+    {
+        const q8_8 x0 = x << 8;
+        const q8_8 y0 = y << 8;
+        const uint32_t sum = 2 * hypotQ8_8(x0 - (3 << 8), y0 - (12 << 8))
+                           + hypotQ8_8(x0 - (9 << 8), y0 - (4 << 8))
+                           + hypotQ8_8(x0 - (14 << 8), y0 - (7 << 8));
+        return sum >> 8;
+    }
+
+    template <typename Kernel>
+    uint64_t nsPerFrame(Kernel kernel)
+    {
+        const uint16_t frames = 2000;
+        volatile uint8_t sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint16_t frame = 0; frame < frames; ++frame) {
+            for (uint8_t y = 0; y < 16; ++y) {
+                for (uint8_t x = 0; x < 16; ++x) {
+                    sink = sink + kernel(frame, x, y);
+                }
+            }
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / frames;
+    }
+
+} // namespace
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_isqrt32_is_floor_of_sqrt()
+{
+    for (uint32_t value = 0; value < (1UL << 20); ++value) {
+        TEST_ASSERT_EQUAL_UINT16(uint16_t(floor(sqrt(double(value)))), isqrt32(value));
+    }
+    for (uint32_t value = 0xFFFFFFFF; value > (1UL << 20); value -= 65521) {
+        TEST_ASSERT_EQUAL_UINT16(uint16_t(floor(sqrt(double(value)))), isqrt32(value));
+    }
+}
+
+void test_hypot_within_one_step()
+{
+    // Sinusoid offsets stay within +-30 px, in 1/16 px steps here
+    for (int32_t x = -30 * 256; x <= 30 * 256; x += 16) {
+        for (int32_t y = -30 * 256; y <= 30 * 256; y += 16) {
+            const double expected = hypot(double(x), double(y));
+            TEST_ASSERT_FLOAT_WITHIN(1.0, expected, double(hypotQ8_8(x, y)));
+        }
+    }
+}
+
+void test_sine_within_tolerance()
+{
+    // of full scale, see FixedMath.h
+    for (uint32_t angle = 0; angle < 65536; ++angle) {
+        const double radians = angle * 2 * M_PI / 65536;
+        TEST_ASSERT_FLOAT_WITHIN(0.007 * 32767, sin(radians) * 32767, double(sinQ15(angle)));
+        TEST_ASSERT_FLOAT_WITHIN(0.007 * 32767, cos(radians) * 32767, double(cosQ15(angle)));
+    }
+    for (int32_t radians = -30 * 256; radians <= 30 * 256; ++radians) {
+        TEST_ASSERT_FLOAT_WITHIN(0.0075 * 32767, sin(radians / 256.0) * 32767, double(sinRadians(radians)));
+    }
+}
+
+void test_mul_q15()
+{
+    TEST_ASSERT_EQUAL_INT32(-32768, mulQ15(65535, -16384));
+    TEST_ASSERT_INT_WITHIN(1, 1000, mulQ15(2000, 16384));
+    TEST_ASSERT_INT_WITHIN(1, -30000, mulQ15(30000, -32767));
+}
+
+void test_sinusoid_pixels_match_float()
+{
+    // the commit that ported Sinusoid promised 2/255 of the float output
+    for (int32_t x = -30 * 256; x <= 30 * 256; x += 64) {
+        for (int32_t y = -30 * 256; y <= 30 * 256; y += 64) {
+            TEST_ASSERT_INT_WITHIN(2, waveFloat(x / 256.0f, y / 256.0f), waveFixed(x, y));
+        }
+    }
+}
+
+void test_metaballs_distance_matches_float()
+{
+    // float truncates each of the three distances, fixed point only the sum
+    for (uint8_t y = 0; y < 16; ++y) {
+        for (uint8_t x = 0; x < 16; ++x) {
+            TEST_ASSERT_INT_WITHIN(3, metaBallsFloat(x, y), metaBallsFixed(x, y));
+        }
+    }
+}
+
+void test_benchmark_frame()
+{
+    const uint64_t sinusoidFloat = nsPerFrame([](uint16_t frame, uint8_t x, uint8_t y) {
+        return waveFloat(x - 8 + frame * 0.01f, y - 8.0f);
+    });
+    const uint64_t sinusoidFixed = nsPerFrame([](uint16_t frame, uint8_t x, uint8_t y) {
+        return waveFixed(((x - 8) << 8) + frame * 3, (y - 8) << 8);
+    });
+    const uint64_t metaBallsF = nsPerFrame([](uint16_t frame, uint8_t x, uint8_t y) {
+        return metaBallsFloat(x, y);
+    });
+    const uint64_t metaBallsQ = nsPerFrame([](uint16_t frame, uint8_t x, uint8_t y) {
+        return metaBallsFixed(x, y);
+    });
+    char message[160];
+    snprintf(message, sizeof(message), "16x16 ns/frame, one channel: sinusoid float %llu fixed %llu, metaballs float %llu fixed %llu",
+        (unsigned long long)sinusoidFloat, (unsigned long long)sinusoidFixed,
+        (unsigned long long)metaBallsF, (unsigned long long)metaBallsQ);
+    // hosts have an FPU, the numbers only compare the shape of both kernels
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_isqrt32_is_floor_of_sqrt);
+    RUN_TEST(test_hypot_within_one_step);
+    RUN_TEST(test_sine_within_tolerance);
+    RUN_TEST(test_mul_q15);
+    RUN_TEST(test_sinusoid_pixels_match_float);
+    RUN_TEST(test_metaballs_distance_matches_float);
+    RUN_TEST(test_benchmark_frame);
+    return UNITY_END();
+}
@@ -0,0 +1,57 @@
+#pragma once
+// Frame hashes of every effect on the host, generated by
+// .pio/build/native/program -w 16 -h 16 -n 8 -s 1 -g, see README
+
+#include <stdint.h>
+
+const uint8_t goldenWidth = 16;
+const uint8_t goldenHeight = 16;
+const uint32_t goldenSeed = 1;
+const uint16_t goldenFrames = 8;
+
+struct GoldenFrames
+{
+    const char* id;
+    uint32_t hashes[8];
+};
+
+const GoldenFrames golden[] = {
+    {"Sparkles", {0x428bdf8c, 0x5d7f3e5c, 0xb6d76b76, 0x38593ebf, 0x87b7806b, 0xf044ea85, 0xed8274f3, 0xfadd6662}},
+    {"Fire", {0xf59c39c5, 0x160a2186, 0x70f1321f, 0x2eb13f9c, 0x6511b884, 0xb06e813c, 0x4ac6f133, 0x4e32f71b}},
+    {"VerticalRainbow", {0x69b3ac45, 0x69b3ac45, 0x69b3ac45, 0x69b3ac45, 0x69b3ac45, 0x69b3ac45, 0xf732c055, 0xf732c055}},
+    {"HorizontalRainbow", {0xe09e4f05, 0xe09e4f05, 0xe09e4f05, 0xe09e4f05, 0xe09e4f05, 0xe09e4f05, 0x04c441d5, 0x04c441d5}},
+    {"Colors", {0x71cdf8c5, 0x97657dc5, 0xfb99d3c5, 0x306cddc5, 0x6b0b9ec5, 0x7c23bec5, 0x16041ec5, 0xa5e553c5}},
+    {"Color", {0x291996c5, 0x291996c5, 0x291996c5, 0x291996c5, 0x291996c5, 0x291996c5, 0x291996c5, 0x291996c5}},
+    {"Snow", {0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0x5656333c}},
+    {"Matrix", {0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0x110310e0}},
+    {"Lighters", {0xec50fe5f, 0x4d7f531e, 0x285b9212, 0xfce3244a, 0x934e6d4e, 0x4646bcc5, 0x9207d5d5, 0x20a3171e}},
+    {"Starfall", {0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf59c39c5, 0xf790ba57}},
+    {"DiagonalRainbow", {0x28b86b2d, 0xabe87b49, 0x3b7795c5, 0xdc2f68c1, 0xc27643a5, 0x4c38e3ad, 0x76a76605, 0xb56e370d}},
+    {"Waterfall", {0x4653579d, 0x1f24be6a, 0x230fbb48, 0x057513d0, 0xf4b4ea6e, 0x1f265c75, 0xcc3c5dfb, 0x9bb41597}},
+    {"TwirlRainbow", {0xf2e6c8b3, 0x0710f946, 0x29b94e9c, 0x37905a3f, 0x54733207, 0x4c5596a4, 0xef3cfd20, 0xcc8e55e7}},
+    {"PulseCircles", {0xf59c39c5, 0x1918348a, 0x5650f902, 0x289e56d2, 0x191d7c2a, 0x60501b6d, 0xbda66403, 0x25574b98}},
+    {"Storm", {0xe134a6ed, 0x4f168250, 0xbd329612, 0xa3e536f8, 0x5d0d768a, 0x9d7b1f40, 0xa8ff876e, 0x4fe8dc82}},
+    {"Matrix2", {0x6d056ec5, 0x0c567691, 0xc2474b9b, 0xbcebf04d, 0x8cd5d231, 0xca1c29b9, 0x0e04fd5b, 0x47270087}},
+    {"TrackingLighters", {0xa253cd3d, 0x2d017dcd, 0xdffaa5ef, 0x1b713b72, 0x03e1cf0f, 0x25494d4d, 0x928e38f2, 0xbbc6b761}},
+    {"LightBalls", {0xd6de4be5, 0x8a59649d, 0x3b1cf1b8, 0xb22e8414, 0xb00983bb, 0x3bdf81fc, 0x24f63433, 0xec13a14c}},
+    {"MovingCube", {0x4a94c5f5, 0x2d354915, 0x280ff7f5, 0xe8604655, 0xafc46115, 0x2b0115f5, 0x98901815, 0x3713b735}},
+    {"WhiteColor", {0x7f10a6c5, 0x7f10a6c5, 0x7f10a6c5, 0x7f10a6c5, 0x7f10a6c5, 0x7f10a6c5, 0x7f10a6c5, 0x7f10a6c5}},
+    {"PulsingComet", {0xdc413176, 0xb48b82c6, 0x13d8389a, 0x11fdbc68, 0x207e5d98, 0x61caed48, 0x7126f9bf, 0x150fe0a9}},
+    {"DoubleComets", {0xdf244296, 0xe4367058, 0xa4afa345, 0x80d8f378, 0xe0c40c9d, 0x4eef964b, 0x636bcf61, 0x33d5804f}},
+    {"TripleComets", {0x057dc535, 0x323ccbe8, 0x8a044040, 0xc07b2efb, 0x2dfec1f5, 0x22e05003, 0xcb288ed4, 0x836e972c}},
+    {"RainbowComet", {0xba4f5a3f, 0x7b8b847f, 0x603bf0ad, 0x2eafbe0f, 0x691183fd, 0xbf8b4dfd, 0x88f9414f, 0x99f34fcd}},
+    {"ColorComet", {0x0db86560, 0x2ef843ce, 0x7a6d2ed0, 0xe114c555, 0x8275d145, 0xac184b03, 0xb9d81d25, 0x47ba1d9c}},
+    {"MovingFlame", {0xebea6bb4, 0xfa2b15bf, 0xfea426f8, 0x21c0eb99, 0xa4f5bbe8, 0x52a00a4e, 0xd71a731b, 0x0a7ec3d8}},
+    {"FractorialFire", {0xcb71a21a, 0x58ad0a2e, 0x90593a28, 0x2d626c81, 0x800ef81e, 0x0629cc08, 0x234ad544, 0x2beaf085}},
+    {"RainbowKite", {0x5e34a3c3, 0x8e5a0d2b, 0x11916117, 0xbdcd20f5, 0xf29081e1, 0x3c44e45d, 0xf87ecd87, 0xa322ae41}},
+    {"BouncingBalls", {0x5c91dbbc, 0x12fffbb5, 0x7e7647f1, 0xf691549b, 0x4108bc23, 0x857a1fab, 0x29335764, 0x61227487}},
+    {"Spiral", {0x495b2fb0, 0xc253baf8, 0xf84c3d89, 0xfce99f75, 0xa714c7bd, 0x4267033a, 0x4d17e11a, 0x87a8e225}},
+    {"MetaBalls", {0x4e7f5e17, 0x0f63a747, 0x643d910e, 0x91342e99, 0xfdde765c, 0x5546ad77, 0x4f939b0d, 0x1c122d4f}},
+    {"Sinusoid", {0xa1320446, 0xd0680e00, 0xe88e838d, 0xe365d036, 0xf8539c94, 0x1577ba06, 0x3982715e, 0xbd74acf3}},
+    {"WaterfallPalette", {0xcef6c716, 0x7ed3ec86, 0x87141986, 0xe5b29dbf, 0x06719587, 0xf6ead663, 0xbacac6cb, 0x44519b4c}},
+    {"Rain", {0x028e288d, 0x6da9023b, 0x4034dee9, 0x3574226c, 0xf22bf708, 0x956155fa, 0xde2fceb4, 0x186b0305}},
+    {"Prismata", {0xa58157f8, 0xdf7c367f, 0x355104cd, 0xff263593, 0xa908e0c5, 0xa3fa1317, 0x6d192680, 0xf138b71a}},
+    {"Flock", {0x4326cf11, 0x06a6f1ff, 0xc7beb3cf, 0xbb81382f, 0x6a106799, 0xf5aad775, 0x80872dcc, 0xd7fbd653}},
+    {"Whirl", {0x409c99b1, 0xdbd51b73, 0x8eac3a71, 0x7a402a93, 0xdcf0d548, 0xf75565d4, 0xa29ec184, 0x70383e2d}},
+    {"Wave", {0x314715e7, 0x549deb7f, 0x8d841c95, 0x9c8273a1, 0x0fc9bc05, 0x6b6c2d31, 0xb1bfb055, 0x268b51d1}},
+};
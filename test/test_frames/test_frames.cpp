@@ -0,0 +1,70 @@
+// Renders every registered effect on the host and compares the hash of
+// each frame to golden_16x16.h. Run with `platformio test -e native`.
+// After an intended change of the output regenerate the header, see README.
+#include <unity.h>
+
+#include "EffectFactories.h"
+#include "HostRender.h"
+#include "MyMatrix.h"
+#include "Settings.h"
+
+#include "golden_16x16.h"
+
+#include <stdio.h>
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_every_effect_has_golden_frames()
+{
+    for (uint8_t factory = 0; factory < EffectFactories::count(); ++factory) {
+        const String id = EffectFactories::id(factory);
+        bool found = false;
+        for (const GoldenFrames& frames : golden) {
+            found |= id == frames.id;
+        }
+        TEST_ASSERT_TRUE_MESSAGE(found, id.c_str());
+    }
+}
+
+void test_frames_match_golden()
+{
+    uint8_t failed = 0;
+    for (const GoldenFrames& frames : golden) {
+        const uint8_t factory = EffectFactories::find(frames.id);
+        if (factory == EffectFactories::count()) {
+            printf("%s is not registered\n", frames.id);
+            ++failed;
+            continue;
+        }
+        int32_t differs = -1;
+        renderEffect(factory, goldenFrames, goldenSeed, [&](uint16_t frame, const CRGB* leds) {
+            if (differs < 0 && MyMatrix::hashFrame(leds) != frames.hashes[frame]) {
+                differs = frame;
+            }
+        });
+        if (differs >= 0) {
+            printf("%s: frame %d differs\n", frames.id, differs);
+            ++failed;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, failed);
+}
+
+int main(int argc, char** argv)
+{
+    Settings::Initialize();
+    mySettings->matrixSettings.width = goldenWidth;
+    mySettings->matrixSettings.height = goldenHeight;
+    MyMatrix::Initialize();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_every_effect_has_golden_frames);
+    RUN_TEST(test_frames_match_golden);
+    return UNITY_END();
+}
@@ -0,0 +1,65 @@
+// The split of the led array over several ESP32 data pins, see LedStrips.h
+#include <unity.h>
+
+#include "LedStrips.h"
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_single_strip_takes_all()
+{
+    TEST_ASSERT_EQUAL_UINT16(0, stripStart(0, 1, 256));
+    TEST_ASSERT_EQUAL_UINT16(256, stripLength(0, 1, 256));
+}
+
+void test_32x32_on_three_pins()
+{
+    TEST_ASSERT_EQUAL_UINT16(0, stripStart(0, 3, 1024));
+    TEST_ASSERT_EQUAL_UINT16(341, stripLength(0, 3, 1024));
+    TEST_ASSERT_EQUAL_UINT16(341, stripStart(1, 3, 1024));
+    TEST_ASSERT_EQUAL_UINT16(341, stripLength(1, 3, 1024));
+    TEST_ASSERT_EQUAL_UINT16(682, stripStart(2, 3, 1024));
+    TEST_ASSERT_EQUAL_UINT16(342, stripLength(2, 3, 1024));
+}
+
+void test_strips_cover_every_led_once()
+{
+    // up to the 8 RMT channels of the ESP32
+    for (uint8_t strips = 1; strips <= 8; ++strips) {
+        for (uint32_t count = 0; count <= 2048; ++count) {
+            TEST_ASSERT_EQUAL_UINT16(0, stripStart(0, strips, count));
+            TEST_ASSERT_EQUAL_UINT16(count, stripStart(strips, strips, count));
+            uint16_t shortest = 0xFFFF;
+            uint16_t longest = 0;
+            for (uint8_t strip = 0; strip < strips; ++strip) {
+                const uint16_t length = stripLength(strip, strips, count);
+                TEST_ASSERT_EQUAL_UINT16(stripStart(strip + 1, strips, count), stripStart(strip, strips, count) + length);
+                shortest = length < shortest ? length : shortest;
+                longest = length > longest ? length : longest;
+            }
+            TEST_ASSERT_TRUE(longest - shortest <= 1);
+        }
+    }
+}
+
+void test_largest_matrix_does_not_overflow()
+{
+    TEST_ASSERT_EQUAL_UINT16(57343, stripStart(7, 8, 65535));
+    TEST_ASSERT_EQUAL_UINT16(65535, stripStart(8, 8, 65535));
+    TEST_ASSERT_EQUAL_UINT16(8192, stripLength(7, 8, 65535));
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_single_strip_takes_all);
+    RUN_TEST(test_32x32_on_three_pins);
+    RUN_TEST(test_strips_cover_every_led_once);
+    RUN_TEST(test_largest_matrix_does_not_overflow);
+    return UNITY_END();
+}
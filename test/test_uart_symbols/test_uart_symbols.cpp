@@ -0,0 +1,97 @@
+// encodeUartSymbols() against a model of the inverted 6N1 UART line,
+// bit for bit for every byte value, see UartSymbols.h
+#include <unity.h>
+
+#include "UartSymbols.h"
+
+namespace {
+
+    // The 32 line bits of four characters, first sent in the top bit:
+    // per character an inverted start bit, the six data bits LSB first
+    // inverted, an inverted stop bit
+    uint32_t lineBits(const uint8_t* characters)
+    {
+        uint32_t bits = 0;
+        for (uint8_t c = 0; c < 4; ++c) {
+            bits = (bits << 1) | 1;
+            for (uint8_t bit = 0; bit < 6; ++bit) {
+                bits = (bits << 1) | (((characters[c] >> bit) & 1) ^ 1);
+            }
+            bits = bits << 1;
+        }
+        return bits;
+    }
+
+    // WS2812 waveform of a byte MSB first in 4 line bits per data bit
+    uint32_t waveform(uint8_t value)
+    {
+        uint32_t bits = 0;
+        for (int8_t bit = 7; bit >= 0; --bit) {
+            bits = (bits << 4) | ((value >> bit) & 1 ? 0b1110 : 0b1000);
+        }
+        return bits;
+    }
+
+} // namespace
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_known_characters()
+{
+    uint8_t out[4];
+    encodeUartSymbols(0x00, out);
+    const uint8_t zeros[4] = { 0b110111, 0b110111, 0b110111, 0b110111 };
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(zeros, out, 4);
+
+    encodeUartSymbols(0xFF, out);
+    const uint8_t ones[4] = { 0b000100, 0b000100, 0b000100, 0b000100 };
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ones, out, 4);
+
+    encodeUartSymbols(0b10010011, out);
+    const uint8_t mixed[4] = { 0b110100, 0b000111, 0b110111, 0b000100 };
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(mixed, out, 4);
+}
+
+void test_every_byte_matches_waveform()
+{
+    for (uint16_t value = 0; value < 256; ++value) {
+        uint8_t out[4];
+        encodeUartSymbols(value, out);
+        TEST_ASSERT_EQUAL_HEX32(waveform(value), lineBits(out));
+        for (uint8_t c = 0; c < 4; ++c) {
+            // 6N1 characters, the top bits never reach the line
+            TEST_ASSERT_EQUAL_HEX8(0, out[c] & 0xC0);
+        }
+    }
+}
+
+void test_frame_is_contiguous()
+{
+    const uint8_t pixels[6] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC };
+    uint8_t frame[6 * 4 + 1];
+    frame[6 * 4] = 0xA5;
+    uint8_t* out = frame;
+    for (uint8_t i = 0; i < 6; ++i) {
+        out = encodeUartSymbols(pixels[i], out);
+    }
+    TEST_ASSERT_TRUE(out == frame + 6 * 4);
+    TEST_ASSERT_EQUAL_HEX8(0xA5, frame[6 * 4]);
+    for (uint8_t i = 0; i < 6; ++i) {
+        TEST_ASSERT_EQUAL_HEX32(waveform(pixels[i]), lineBits(frame + i * 4));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_known_characters);
+    RUN_TEST(test_every_byte_matches_waveform);
+    RUN_TEST(test_frame_is_contiguous);
+    return UNITY_END();
+}
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""Compare effect output of a lamp built with -DUSE_PROFILER to golden values.
+
+Every registered effect is rendered offscreen from a fresh start with a fixed
+random seed and the hash of each frame is compared to the golden file. Golden
+files are per matrix size, record them once with --update.
+
+With --tolerance N effects whose hashes differ are rendered again as images and
+pass if no channel of the last frame is off by more than N, e.g. after porting
+an effect from float to fixed-point math.
+
+CI checks the host build instead, with the hashes in test/test_frames; this
+script is for output on real hardware.
+"""
+import argparse
+import json
+import sys
+import urllib.error
+import urllib.request
+
+
+def fetch(url):
+    with urllib.request.urlopen(url, timeout=60) as response:
+        return response.read()
+
+
+def read_ppm(data):
+    # binary P6, exactly one whitespace byte separates the header from pixels
+    fields = []
+    position = 0
+    while len(fields) < 4:
+        while data[position:position + 1].isspace():
+            position += 1
+        end = position
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[position:end])
+        position = end
+    if fields[0] != b"P6":
+        raise ValueError("not a binary PPM")
+    width, height = int(fields[1]), int(fields[2])
+    return width, height, data[position + 1:position + 1 + width * height * 3]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("lamp", help="lamp address, e.g. 192.168.1.50")
+    parser.add_argument("golden", help="golden json file, e.g. golden-16x16.json")
+    parser.add_argument("--frames", type=int, default=8)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--tolerance", type=int, default=0, help="max channel difference of the last frame")
+    parser.add_argument("--update", action="store_true", help="record current output as golden")
+    args = parser.parse_args()
+
+    base = "http://%s" % args.lamp
+    hashes = json.loads(fetch("%s/render/hashes?frames=%d&seed=%d" % (base, args.frames, args.seed)))
+
+    if args.update:
+        golden = {"frames": args.frames, "seed": args.seed, "hashes": hashes, "images": {}}
+        if args.tolerance:
+            for effect in hashes:
+                url = "%s/render?i=%s&frames=%d&seed=%d" % (base, effect, args.frames, args.seed)
+                try:
+                    golden["images"][effect] = fetch(url).hex()
+                except urllib.error.HTTPError:
+                    pass  # effect is not in effects.json
+        with open(args.golden, "w") as out:
+            json.dump(golden, out, indent=2, sort_keys=True)
+        print("recorded %d effects to %s" % (len(hashes), args.golden))
+        return 0
+
+    with open(args.golden) as f:
+        golden = json.load(f)
+    if golden["frames"] != args.frames or golden["seed"] != args.seed:
+        print("golden file was recorded with frames=%d seed=%d" % (golden["frames"], golden["seed"]))
+        return 2
+
+    failed = 0
+    for effect, expected in sorted(golden["hashes"].items()):
+        actual = hashes.get(effect)
+        if actual is None:
+            print("SKIP %s (active or not registered)" % effect)
+            continue
+        if actual == expected:
+            continue
+        image = golden["images"].get(effect)
+        if args.tolerance and image:
+            url = "%s/render?i=%s&frames=%d&seed=%d" % (base, effect, args.frames, args.seed)
+            width, height, expected_pixels = read_ppm(bytes.fromhex(image))
+            _, _, pixels = read_ppm(fetch(url))
+            diff = max(abs(a - b) for a, b in zip(pixels, expected_pixels))
+            if diff <= args.tolerance:
+                print("OK   %s (max difference %d)" % (effect, diff))
+                continue
+            print("FAIL %s (max difference %d)" % (effect, diff))
+        else:
+            # hashes differ in length when the golden file has other frames
+            frame = next((i for i, (a, b) in enumerate(zip(actual, expected)) if a != b),
+                         min(len(actual), len(expected)))
+            print("FAIL %s (frame %d differs)" % (effect, frame))
+        failed += 1
+
+    print("%d of %d effects differ" % (failed, len(golden["hashes"])))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())